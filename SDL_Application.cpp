@@ -3,19 +3,26 @@
 
 SDL_Application::SDL_Application() { // Constructor
 	
-	if (!SDL_Init(SDL_FLAGS)) { // Initialize SDL module
+	// only video starts here - ttf starts with the first font, audio with open_audio()
+	if (!SDL_Runtime::instance().acquire_video()) {
 		throw std::runtime_error("Error initiating SDL.\n");
 	}
-	
-	
-	if (!TTF_Init()) { // initialize TTF module
-		throw std::runtime_error("Error initiating TTF.\n");
-	}
-	
-	
-	if (!MIX_Init()) { // initialize Mixer module (audio)
-		throw std::runtime_error("Error initiating MIX.\n");
-	}
+	SDL_Runtime::instance().acquire_audio();
+	
+	// a throw skips the destructor - hand back the window and runtime references until construction completes
+	window = NULL;
+	renderer = NULL;
+	
+	struct StartupGuard {
+		SDL_Window **window;
+		bool done;
+		~StartupGuard() {
+			if (done) return;
+			if (*window) SDL_DestroyWindow(*window);
+			SDL_Runtime::instance().release_audio();
+			SDL_Runtime::instance().release_video();
+		}
+	} startup_guard = {&window, false};
 	
 	// create window pointer
 	window = SDL_CreateWindow(window_title, window_width, window_height, 0);
@@ -35,17 +42,20 @@ SDL_Application::SDL_Application() { // Constructor
 		throw std::runtime_error("Error creating Renderer.\n");
 	}
 	
+	assets.set_renderer(renderer); // textures are bound to this renderer
+	text.set_renderer(renderer);
 	
-	// create audiospec struct to initialize mixer
-	SDL_AudioSpec audiospec;
-	audiospec.format = MIX_DEFAULT_FORMAT;
-	audiospec.channels = MIX_DEFAULT_CHANNELS; // stereo or mono
-	audiospec.freq = MIX_DEFAULT_FREQUENCY;
+	// bundle opens in run() or open_bundle() so a subclass bundle_path takes effect - until then, loose files
+	bundle_checked = false;
+	assets.set_bundle(&bundle);
 	
-	// populate mixer and default tracks
-	mixer = MIX_CreateMixerDevice(SDL_AUDIO_DEVICE_DEFAULT_PLAYBACK, &audiospec);
-	sfx_track = MIX_CreateTrack(mixer);
-	music_track = MIX_CreateTrack(mixer);
+	
+	// audio device and tracks are opened by open_audio() on first use
+	mixer = NULL;
+	music_track = NULL;
+	
+	loader.set_targets(&assets, NULL); // decoded images go to asset cache - audio isn't tied to a mixer until played
+	loader.set_bundle(&bundle);
 	
 	
 	// set up window icon - destroyed after use to free up memory
@@ -63,13 +73,36 @@ SDL_Application::SDL_Application() { // Constructor
 	
 	key_states = SDL_GetKeyboardState(NULL); // initialize keyboard state variable
 	
+	// first frame is always drawn
+	redraw_requested = true;
+	dirty_rect = {0.0f, 0.0f, 0.0f, 0.0f};
+	redraw_rect = dirty_rect;
+	skipped_frames = 0;
+	
+	// pipeline is set up in run() if enabled
+	snapshot_middle.store(2);
+	snapshot_write = 0;
+	snapshot_read = 1;
+	sim_start = NULL;
+	sim_done = NULL;
+	sim_stop = false;
+	sim_error = NULL;
+	sim_ns = 0;
+	render_ns = 0;
+	pipeline_overlap = 0.0;
+	
 	is_running = true;
+	
+	startup_guard.done = true; // destructor owns window, renderer and runtime references from here on
 		
 }
 
 
 SDL_Application::~SDL_Application() { // DESTRUCTOR - CLEAN UP MEMORY
 	
+	loader.shutdown(); // stop workers before the targets they load into disappear
+	assets.clear();    // textures must go before their renderer
+	text.clear();      // also closes fonts before TTF goes offline
 	
 	if (renderer) { // if pointer to renderer is available
 		SDL_DestroyRenderer(renderer); // free memory at renderer pointer
@@ -81,33 +114,104 @@ SDL_Application::~SDL_Application() { // DESTRUCTOR - CLEAN UP MEMORY
 		window = NULL;             // set dangling pointer to null
 	}
 	
-	if (mixer) { // if pointer to mixer is available
-		MIX_DestroyMixer(mixer); // free memory at mixer pointer
-		mixer = NULL;            // set dangling pointer to null
+	sfx_voices.destroy(); // mixer is shared - only our own tracks go
+	
+	if (music_track) {
+		MIX_DestroyTrack(music_track);
+		music_track = NULL;
 	}
+	mixer = NULL;
 	
-	MIX_Quit();         // take mixer module offline
-	TTF_Quit();         // take ttf module offline
-	SDL_Quit();         // take module offline after unallocating memory
+	// runtime closes the device and takes SDL offline once no other user holds them
+	SDL_Runtime::instance().release_audio();
+	SDL_Runtime::instance().release_video();
 	
 }
 
 
 void SDL_Application::run() {
 	
+	// apply loop policy here rather than in constructor so subclass overrides take effect
+	open_bundle();
+	
+	if (!SDL_SetRenderVSync(renderer, vsync ? 1 : SDL_RENDERER_VSYNC_DISABLED)) {
+		fprintf(stderr, "Error setting vsync: %s\n", SDL_GetError());
+	}
+	
+	accumulator = 0.0;
+	alpha = 0.0;
+	frame_count = 0;
+	frame_period_ns = 0;
+	frame_work_ns = 0;
+	
 	last_time = SDL_GetTicksNS();
+	frame_start = last_time;
+	frame_deadline = last_time;
+	
+	// stops and joins the simulation thread however run() is left - return or exception
+	struct PipelineGuard {
+		SDL_Application *app;
+		~PipelineGuard() { if (app) app->stop_pipeline(); }
+	} pipeline_guard = {pipelined ? this : NULL};
+	
+	if (pipelined) {
+		start_pipeline();
+	}
 	
 	while(is_running) {
 		events();
 		update();
-		draw();
-	}	
+		
+		if (!pipelined) {
+			draw();
+		}
+		else {
+			// simulate next frame on worker while this one is submitted
+			uint64_t kick = SDL_GetTicksNS();
+			SDL_SignalSemaphore(sim_start);
+			draw();
+			render_ns = SDL_GetTicksNS() - kick;
+			SDL_WaitSemaphore(sim_done);
+			
+			if (sim_error) { // worker has stopped - guard joins it on the way out
+				std::exception_ptr error = sim_error;
+				sim_error = NULL;
+				std::rethrow_exception(error);
+			}
+			
+			// overlap - how much of the shorter side ran concurrently with the other
+			uint64_t wall = SDL_GetTicksNS() - kick;
+			uint64_t shorter = sim_ns < render_ns ? sim_ns : render_ns;
+			if (shorter > 0) {
+				double hidden = (double)(sim_ns + render_ns) - (double)wall;
+				double overlap = hidden > 0.0 ? hidden / (double)shorter : 0.0;
+				pipeline_overlap = pipeline_overlap * 0.9 + (overlap > 1.0 ? 1.0 : overlap) * 0.1;
+			}
+		}
+		
+		pace_frame();
+		SDL_PROFILE_FRAME(); // fold this frame's zones into rolling stats
+	}
 }
 
 
 void SDL_Application::events() {
 	
-	while (SDL_PollEvent(&event)) { // poll until all events are handled
+	SDL_PROFILE_ZONE("events");
+	
+	// on-demand mode with nothing to draw - sleep in the event queue until input arrives
+	bool waited = false;
+	if (on_demand && !redraw_requested) {
+		waited = SDL_WaitEventTimeout(&event, idle_timeout_ms);
+	}
+	
+	while (waited || SDL_PollEvent(&event)) { // poll until all events are handled
+		
+		waited = false;
+		
+		if (on_demand) { // any input may change what is on screen
+			request_redraw();
+		}
 	
 		// check struct type of event
 		// adapt action based on type
@@ -117,6 +221,11 @@ void SDL_Application::events() {
 				is_running = false;
 				break;
 			
+			case SDL_EVENT_WINDOW_RESIZED: // keep view size in sync for culling and redraw regions
+				window_width = event.window.data1;
+				window_height = event.window.data2;
+				break;
+			
 			// TO DO: ENABLE BREAKING OF RUN LOOP WITH MULTIPLE WINDOWS OPEN
 			/*
 				
@@ -148,26 +257,298 @@ void SDL_Application::events() {
 
 void SDL_Application::update() {
 	
+	SDL_PROFILE_ZONE("update");
+	
 	SDL_PumpEvents();
 	
+	// main thread only - uploads need the renderer
+	loader.pump(upload_budget_ns); // upload finished background loads
+	sfx_voices.begin_frame();
+	
+	if (!pipelined) { // pipelined mode simulates on the worker, kicked from run()
+		simulate();
+	}
+	
+}
+
+
+void SDL_Application::simulate() {
+	
+	SDL_PROFILE_ZONE("simulate");
+	
 	// update delta variable
 	current_time = SDL_GetTicksNS();
 	delta = (double)(current_time - last_time) / (double)SDL_NS_PER_SECOND; // calculate duration of previous refresh cycle, set delta
 	last_time = current_time;
 	
-	update_ext();
+	if (!fixed_timestep) { // variable timestep - one update per frame
+		update_ext();
+		world.update(delta);
+		return;
+	}
+	
+	// fixed timestep - consume elapsed time in steps of fixed_delta, carry the remainder
+	accumulator += delta;
+	delta = fixed_delta; // update_ext() sees the step length, not the frame length
+	
+	int steps = 0;
+	while (accumulator >= fixed_delta && steps < max_fixed_steps) {
+		update_ext();
+		world.update(delta);
+		accumulator -= fixed_delta;
+		steps++;
+	}
+	
+	if (accumulator >= fixed_delta) { // stalled for too long - drop backlog instead of spiralling
+		accumulator = fmod(accumulator, fixed_delta);
+	}
+	
+	alpha = accumulator / fixed_delta; // how far draw_ext() is between last and next step
 	
 }
 
 
 void SDL_Application::draw() {
+	
+	if (on_demand && !redraw_requested) { // nothing changed - keep last presented frame
+		skipped_frames++;
+		return;
+	}
+	
+	SDL_PROFILE_ZONE("draw");
+	
+	// hand dirty region to draw_ext() and reset it, so draw_ext() may request a follow-up frame
+	redraw_rect = dirty_rect;
+	dirty_rect = {0.0f, 0.0f, 0.0f, 0.0f};
+	redraw_requested = false;
+	
 	SDL_RenderClear(renderer); // clear renderer buffer
 	
-	draw_ext(); // extended draw function for actual application
+	if (!pipelined) {
+		cull_visible();
+		draw_ext(); // extended draw function for actual application
+	}
+	else {
+		// take newest published snapshot if there is one, otherwise redraw the current one
+		if (snapshot_middle.load(std::memory_order_acquire) & SNAPSHOT_FRESH) {
+			snapshot_read = snapshot_middle.exchange(snapshot_read, std::memory_order_acq_rel) & 3;
+		}
+		snapshots[snapshot_read].flush(renderer, false); // kept - may be needed again next frame
+		
+		draw_ext(); // main thread pass for anything that needs the renderer - text, hud
+	}
+	
+	sprite_batch.flush(renderer); // submit sprites queued in draw_ext()
+	
+#ifdef SDL_APP_PROFILE
+	if (profiler_overlay) {
+		SDL_Profiler::instance().draw_overlay(renderer, 8.0f, 8.0f);
+	}
+#endif
 	
-	SDL_RenderPresent(renderer);
+	{
+		SDL_PROFILE_ZONE("present");
+		SDL_RenderPresent(renderer);
+	}
 	
 }
 
 
+void SDL_Application::request_redraw() {
+	mark_dirty({0.0f, 0.0f, (float)window_width, (float)window_height});
+}
 
+
+void SDL_Application::mark_dirty(const SDL_FRect &rect) {
+	
+	// the back buffer is undefined after present, so the whole frame is still redrawn -
+	// the union only tells draw_ext() which part actually changed
+	if (dirty_rect.w <= 0.0f || dirty_rect.h <= 0.0f) {
+		dirty_rect = rect;
+	}
+	else {
+		SDL_GetRectUnionFloat(&dirty_rect, &rect, &dirty_rect);
+	}
+	
+	redraw_requested = true;
+}
+
+
+void SDL_Application::pace_frame() {
+	
+	uint64_t now = SDL_GetTicksNS();
+	frame_work_ns = now - frame_start;
+	
+	if (target_fps > 0) {
+		
+		uint64_t period = SDL_NS_PER_SECOND / (uint64_t)target_fps;
+		frame_deadline += period;
+		
+		if (now < frame_deadline) {
+			// sleep through most of the remaining time, then spin the rest -
+			// the scheduler may oversleep by a millisecond or more
+			if (frame_deadline - now > pacing_spin_ns) {
+				SDL_DelayNS(frame_deadline - now - pacing_spin_ns);
+			}
+			while ((now = SDL_GetTicksNS()) < frame_deadline) {}
+		}
+		else if (now - frame_deadline > period) { // fell more than a frame behind - resync
+			frame_deadline = now;
+		}
+	}
+	
+	frame_period_ns = now - frame_start;
+	frame_start = now;
+	frame_count++;
+	
+}
+
+
+bool SDL_Application::open_bundle() {
+	
+	if (bundle_checked) {
+		return bundle.is_open();
+	}
+	
+	// packed assets are optional - without a bundle everything loads from loose files
+	if (!bundle_path || !SDL_GetPathInfo(bundle_path, NULL)) {
+		bundle_checked = true;
+		return false;
+	}
+	
+	// loader workers read the bundle index - it can't change under a running load
+	if (!loader.idle()) {
+		fprintf(stderr, "Error - bundle \"%s\" not opened: background loads already running, call open_bundle() before them.\n", bundle_path);
+		bundle_checked = true;
+		return false;
+	}
+	
+	bundle_checked = true;
+	return bundle.open(bundle_path);
+	
+}
+
+
+MIX_Mixer *SDL_Application::open_audio() {
+	
+	if (mixer) {
+		return mixer;
+	}
+	
+	mixer = SDL_Runtime::instance().mixer(); // same device as any soundboard in this process
+	if (!mixer) {
+		return NULL;
+	}
+	
+	sfx_voices.create(mixer);
+	music_track = MIX_CreateTrack(mixer);
+	
+	return mixer;
+	
+}
+
+
+SDL_FRect SDL_Application::view_rect() const {
+	return {camera_x, camera_y, (float)window_width, (float)window_height};
+}
+
+
+void SDL_Application::cull_visible() {
+	
+	if (spatial.size() == 0) { // not in use
+		visible.clear();
+		return;
+	}
+	
+	spatial.query_rect(view_rect(), visible);
+}
+
+
+void SDL_Application::start_pipeline() {
+	
+	// dirty state is main thread only - request_redraw()/mark_dirty() from update_ext() on the worker would race draw()
+	if (on_demand) {
+		fprintf(stderr, "Error - on_demand can't be combined with pipelined, redrawing every frame.\n");
+		on_demand = false;
+	}
+	
+	snapshot_write = 0;
+	snapshot_read = 1;
+	snapshot_middle.store(2);
+	
+	for (SDL_SpriteBatch &snapshot : snapshots) {
+		snapshot.clear();
+	}
+	
+	sim_ns = 0;
+	render_ns = 0;
+	pipeline_overlap = 0.0;
+	sim_stop = false;
+	sim_error = NULL;
+	
+	sim_start = SDL_CreateSemaphore(0);
+	sim_done = SDL_CreateSemaphore(0);
+	if (!sim_start || !sim_done) {
+		throw std::runtime_error("Error creating pipeline semaphores.\n");
+	}
+	
+	sim_thread = std::thread(&SDL_Application::sim_loop, this);
+	
+}
+
+
+void SDL_Application::stop_pipeline() {
+	
+	// also cleans up after a start_pipeline() that threw part way
+	if (sim_thread.joinable()) {
+		sim_stop = true;
+		SDL_SignalSemaphore(sim_start); // wake worker so it sees the stop flag
+		sim_thread.join();
+	}
+	
+	if (sim_start) {
+		SDL_DestroySemaphore(sim_start);
+		sim_start = NULL;
+	}
+	if (sim_done) {
+		SDL_DestroySemaphore(sim_done);
+		sim_done = NULL;
+	}
+	
+}
+
+
+void SDL_Application::sim_loop() {
+	
+	while (true) {
+		
+		SDL_WaitSemaphore(sim_start);
+		if (sim_stop) {
+			return;
+		}
+		
+		uint64_t start = SDL_GetTicksNS();
+		
+		try {
+			simulate();
+			
+			// record into private buffer, then publish it with one swap - render side never waits on it
+			SDL_SpriteBatch &snapshot = snapshots[snapshot_write];
+			snapshot.clear();
+			cull_visible();
+			record_ext(snapshot);
+			snapshot_write = snapshot_middle.exchange(snapshot_write | SNAPSHOT_FRESH, std::memory_order_acq_rel) & 3;
+		}
+		catch (...) {
+			// hand it to the main thread (sim_done orders the store) and stop taking frames
+			sim_error = std::current_exception();
+			SDL_SignalSemaphore(sim_done);
+			return;
+		}
+		
+		sim_ns = SDL_GetTicksNS() - start;
+		
+		SDL_SignalSemaphore(sim_done);
+	}
+	
+}
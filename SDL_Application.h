@@ -8,8 +8,21 @@
 #include <SDL3_ttf/SDL_ttf.h>
 #include <SDL3_mixer/SDL_mixer.h>
 
+#include "SDL_AssetCache.h"
+#include "SDL_AssetLoader.h"
+#include "SDL_Profiler.h"
+#include "SDL_Runtime.h"
+#include "SDL_SpatialHash.h"
+#include "SDL_SpriteBatch.h"
+#include "SDL_TextCache.h"
+#include "SDL_VoicePool.h"
+#include "SDL_World.h"
+
+#include <atomic>
+#include <exception>
 #include <iostream>
 #include <memory>
+#include <thread>
 
 #include <stdio.h>
 #include <stdbool.h>
@@ -17,12 +30,7 @@
 #include <time.h>
 #include <math.h>
 
-#define SDL_FLAGS (SDL_INIT_VIDEO | SDL_INIT_AUDIO)
-
-// audio mixer defaults
-#define MIX_DEFAULT_FREQUENCY 44100
-#define MIX_DEFAULT_FORMAT SDL_AUDIO_S16
-#define MIX_DEFAULT_CHANNELS 2
+#define SNAPSHOT_FRESH 4 // flag on snapshot_middle - published but not yet taken by the render side
 
 class SDL_Application {
 	
@@ -32,10 +40,24 @@ protected:
 	SDL_Renderer *renderer;
 	SDL_Event event;
 	
-	MIX_Mixer *mixer;
-	MIX_Track *sfx_track;
+	MIX_Mixer *mixer;         // shared playback device - NULL until open_audio()
+	SDL_VoicePool sfx_voices; // overlapping sfx, stats roll over in update()
 	MIX_Track *music_track;
 	
+	SDL_Bundle bundle;            // packed assets, checked before loose files - outlives assets and loader
+	bool bundle_checked;          // open_bundle() already ran
+	SDL_AssetCache assets;        // images loaded through here share atlas textures
+	SDL_AssetLoader loader;       // background loads, uploaded into assets during update()
+	SDL_SpriteBatch sprite_batch; // flushed at end of draw(), after draw_ext() (and the snapshot in pipelined mode)
+	SDL_TextCache text;           // glyph atlas text, drawn into sprite_batch
+	SDL_World world;              // optional entities/systems, updated after update_ext()
+	SDL_SpatialHash spatial;      // optional index of object boxes by caller id, in world coordinates
+	std::vector<int> visible;     // ids in spatial overlapping the view - refreshed before draw_ext(), or before record_ext() when pipelined (worker owned then)
+	
+	// camera - top left of the view in world coordinates, view size follows the window
+	float camera_x = 0.0f;
+	float camera_y = 0.0f;
+	
 	bool is_running;
 	
 	//input and related values
@@ -54,8 +76,55 @@ protected:
 	int window_height = 500;
 	bool window_resizable = true;
 	const char* window_title = "Application";
+	const char* bundle_path = "assets.bundle"; // opened by run() if present, or earlier via open_bundle() (see SDL_BundlePacker)
 	//const char* icon = "../assets/icon.png";
 	
+	// Frame pacing - override in subclass (applied when run() starts)
+	int target_fps = 0;              // frame cap, 0 = uncapped
+	bool vsync = false;              // let SDL_RenderPresent block on display refresh
+	bool fixed_timestep = false;     // call update_ext() in fixed steps of fixed_delta
+	double fixed_delta = 1.0 / 60.0; // length of one simulation step in seconds
+	int max_fixed_steps = 5;         // cap on catch-up steps per frame after a stall
+	uint64_t pacing_spin_ns = 1500000; // final stretch before a deadline is busy-waited, not slept
+	uint64_t upload_budget_ns = 2000000; // main thread time per frame for uploading background loads
+	bool profiler_overlay = false;       // draw zone percentiles on top (needs SDL_APP_PROFILE)
+	
+	// frame pacing state
+	uint64_t frame_deadline;   // target end time of current frame
+	uint64_t frame_start;      // start time of current frame
+	uint64_t frame_period_ns;  // measured length of the last full frame
+	uint64_t frame_work_ns;    // time of the last frame spent in events/update/draw (excludes pacing)
+	uint64_t frame_count;
+	double accumulator;        // simulation time not yet consumed by fixed steps
+	double alpha;              // interpolation factor between last and next fixed step, for draw_ext()
+	
+	// On-demand redraw - override in subclass
+	bool on_demand = false;    // only redraw when dirty, block in events() while idle
+	int idle_timeout_ms = 100; // longest wait for an event before update() runs anyway
+	
+	// on-demand redraw state
+	bool redraw_requested;
+	SDL_FRect dirty_rect;      // union of regions marked dirty since last drawn frame
+	SDL_FRect redraw_rect;     // dirty region being redrawn - valid inside draw_ext()
+	uint64_t skipped_frames;   // frames where draw() skipped clear/present
+	
+	// Pipelined mode - override in subclass
+	bool pipelined = false;    // simulate frame N+1 on a worker while frame N is rendered from a snapshot - turns on_demand off
+	
+	// pipeline state
+	SDL_SpriteBatch snapshots[3];     // triple-buffered render snapshots, filled by record_ext()
+	std::atomic<int> snapshot_middle; // last published snapshot index, | SNAPSHOT_FRESH until taken
+	int snapshot_write;               // simulation thread only
+	int snapshot_read;                // main thread only
+	std::thread sim_thread;
+	SDL_Semaphore *sim_start;
+	SDL_Semaphore *sim_done;
+	bool sim_stop;
+	std::exception_ptr sim_error; // thrown by simulate()/record_ext() on the worker, rethrown by run()
+	uint64_t sim_ns;           // length of last simulation step (worker)
+	uint64_t render_ns;        // length of last draw() (main thread)
+	double pipeline_overlap;   // smoothed share of the shorter of the two hidden behind the other, 0..1
+	
 	
 public:
 
@@ -70,11 +139,36 @@ protected:
 	void update();
 	void draw();
 	
+	void pace_frame();
+	void simulate();
+	
+	void request_redraw();
+	void mark_dirty(const SDL_FRect &rect);
+	
+	SDL_FRect view_rect() const;
+	void cull_visible();
+	
+	MIX_Mixer *open_audio(); // opens the audio device on first call, sets up sfx_voices and music_track
+	bool open_bundle();      // opens bundle_path once - call in a subclass constructor to load from it before run()
+	
 private:	
 	// Virtual functions - extend in child classes
 	virtual void events_ext() {}
 	virtual void update_ext() {}
+	// Pipelined mode: draw_ext() still runs on the main thread, after the latest snapshot
+	// is drawn and while the next step simulates - keep it to state the simulation doesn't
+	// write (hud, text, overlays).
 	virtual void draw_ext() {}
+	// Pipelined mode - runs on the simulation thread while the main thread renders. SDL
+	// rendering stays on the main thread: only queue sprites of already loaded textures
+	// into snapshot. No renderer calls, no text.draw() (creates and updates glyph
+	// textures), no assets.load() - do those in draw_ext(). Exceptions thrown here or in
+	// update_ext() are rethrown from run().
+	virtual void record_ext(SDL_SpriteBatch &/*snapshot*/) {}
+	
+	void start_pipeline();
+	void stop_pipeline();
+	void sim_loop();
 
 };
 
@@ -0,0 +1,216 @@
+#include "SDL_AssetCache.h"
+
+#include <stdio.h>
+
+
+SDL_AssetCache::SDL_AssetCache() {
+	
+	renderer = NULL;
+	bundle = NULL;
+	
+	hits = 0;
+	misses = 0;
+	bundled = 0;
+	
+}
+
+
+SDL_AssetCache::~SDL_AssetCache() {
+	clear();
+}
+
+
+void SDL_AssetCache::set_renderer(SDL_Renderer *r) {
+	renderer = r;
+}
+
+
+void SDL_AssetCache::set_bundle(const SDL_Bundle *b) {
+	bundle = b;
+}
+
+
+SDL_TextureRegion SDL_AssetCache::load(const std::string &path) {
+	
+	auto found = regions.find(path);
+	if (found != regions.end()) { // already decoded and uploaded
+		hits++;
+		return found->second;
+	}
+	
+	misses++;
+	
+	// bundled images are already RGBA32 - the surface points into the mapping
+	SDL_Surface *surface = bundle ? bundle->surface(path) : NULL;
+	if (surface) {
+		bundled++;
+	}
+	else {
+		surface = IMG_Load(path.c_str());
+	}
+	
+	if (!surface) {
+		fprintf(stderr, "Error loading image \"%s\": %s\n", path.c_str(), SDL_GetError());
+		return {NULL, {0.0f, 0.0f, 0.0f, 0.0f}};
+	}
+	
+	SDL_TextureRegion region = insert(path, surface);
+	SDL_DestroySurface(surface); // pixels live on the gpu now (mapped pixels are not freed with it)
+	
+	return region;
+	
+}
+
+
+std::vector<SDL_TextureRegion> SDL_AssetCache::load_sequence(const char *pattern, int first, int last) {
+	
+	// pattern is a printf format with one int, e.g. "assets/pibEyes/eyes%02d.png"
+	std::vector<SDL_TextureRegion> frames;
+	char path[1024];
+	
+	for (int i = first; i <= last; i++) {
+		SDL_snprintf(path, sizeof(path), pattern, i);
+		frames.push_back(load(path));
+	}
+	
+	return frames;
+}
+
+
+SDL_TextureRegion SDL_AssetCache::insert(const std::string &key, SDL_Surface *surface) {
+	
+	// key already uploaded - overwriting would leak its atlas space or texture
+	auto found = regions.find(key);
+	if (found != regions.end()) {
+		return found->second;
+	}
+	
+	SDL_TextureRegion region = {NULL, {0.0f, 0.0f, 0.0f, 0.0f}};
+	
+	if (!renderer) {
+		fprintf(stderr, "Error - asset cache has no renderer.\n");
+		return region;
+	}
+	
+	int w = surface->w;
+	int h = surface->h;
+	
+	// page_size may be set below max_packed_size - padding included, anything a page can't hold goes standalone
+	bool packable = w <= max_packed_size && h <= max_packed_size && w + padding * 2 <= page_size && h + padding * 2 <= page_size;
+	
+	if (packable) {
+		
+		// atlas pages are RGBA32 - convert first if surface is in another format
+		SDL_Surface *rgba = surface;
+		if (surface->format != SDL_PIXELFORMAT_RGBA32) {
+			rgba = SDL_ConvertSurface(surface, SDL_PIXELFORMAT_RGBA32);
+		}
+		
+		SDL_Texture *texture;
+		SDL_Rect rect;
+		
+		if (rgba && pack(w + padding * 2, h + padding * 2, &texture, &rect)) {
+			
+			SDL_Rect dst = {rect.x + padding, rect.y + padding, w, h};
+			
+			if (SDL_UpdateTexture(texture, &dst, rgba->pixels, rgba->pitch)) {
+				region.texture = texture;
+				region.src = {(float)dst.x, (float)dst.y, (float)w, (float)h};
+			}
+			else {
+				fprintf(stderr, "Error uploading \"%s\" to atlas: %s\n", key.c_str(), SDL_GetError());
+			}
+		}
+		
+		if (rgba && rgba != surface) {
+			SDL_DestroySurface(rgba);
+		}
+	}
+	
+	if (!region.texture) { // too large for a page (or packing failed) - own texture
+		
+		SDL_Texture *texture = SDL_CreateTextureFromSurface(renderer, surface);
+		if (!texture) {
+			fprintf(stderr, "Error creating texture for \"%s\": %s\n", key.c_str(), SDL_GetError());
+			return region;
+		}
+		
+		standalone.push_back(texture);
+		region.texture = texture;
+		region.src = {0.0f, 0.0f, (float)w, (float)h};
+	}
+	
+	regions[key] = region;
+	return region;
+	
+}
+
+
+bool SDL_AssetCache::contains(const std::string &key) const {
+	return regions.find(key) != regions.end();
+}
+
+
+void SDL_AssetCache::clear() {
+	
+	for (Page &page : pages) {
+		SDL_DestroyTexture(page.texture);
+	}
+	pages.clear();
+	
+	for (SDL_Texture *texture : standalone) {
+		SDL_DestroyTexture(texture);
+	}
+	standalone.clear();
+	
+	regions.clear();
+	
+}
+
+
+bool SDL_AssetCache::pack(int w, int h, SDL_Texture **texture, SDL_Rect *rect) {
+	
+	// would not fit an empty page either - don't open one for it
+	if (w > page_size || h > page_size) {
+		return false;
+	}
+	
+	// newest page first - older pages are usually close to full
+	for (size_t i = pages.size(); i-- > 0;) {
+		if (pages[i].packer.pack(w, h, rect)) {
+			*texture = pages[i].texture;
+			return true;
+		}
+	}
+	
+	if (!add_page() || !pages.back().packer.pack(w, h, rect)) {
+		return false;
+	}
+	
+	*texture = pages.back().texture;
+	return true;
+	
+}
+
+
+bool SDL_AssetCache::add_page() {
+	
+	SDL_Texture *texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_STATIC, page_size, page_size);
+	if (!texture) {
+		fprintf(stderr, "Error creating atlas page: %s\n", SDL_GetError());
+		return false;
+	}
+	
+	// static texture contents are undefined - clear once so padding stays transparent
+	std::vector<Uint8> blank((size_t)page_size * page_size * 4, 0);
+	SDL_UpdateTexture(texture, NULL, blank.data(), page_size * 4);
+	SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+	
+	Page page;
+	page.texture = texture;
+	page.packer.reset(page_size, page_size);
+	pages.push_back(page);
+	
+	return true;
+	
+}
@@ -0,0 +1,74 @@
+#ifndef SDL_ASSETCACHE_H
+#define SDL_ASSETCACHE_H
+
+#include <SDL3/SDL.h>
+#include <SDL3_image/SDL_image.h>
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "SDL_AtlasPacker.h"
+#include "SDL_Bundle.h"
+#include "SDL_SpriteBatch.h"
+
+// Image cache keyed by path. Each file is decoded once; images up to
+// max_packed_size are packed into shared atlas pages, larger ones get a
+// texture of their own. Lookups return an SDL_TextureRegion (texture +
+// source rect) that stays valid until clear(). With a bundle set, paths found
+// in it are uploaded from the mapped pixels and never decoded.
+class SDL_AssetCache {
+	
+	struct Page {
+		SDL_Texture *texture;
+		SDL_AtlasPacker packer;
+	};
+	
+	SDL_Renderer *renderer;
+	const SDL_Bundle *bundle;
+	
+	std::vector<Page> pages;
+	std::vector<SDL_Texture*> standalone; // images too large for an atlas page
+	std::unordered_map<std::string, SDL_TextureRegion> regions;
+	
+	// stats
+	int hits;
+	int misses;
+	int bundled;
+	
+	public:
+		// Default values - change before first load
+		int page_size = 1024;      // width and height of atlas pages
+		int max_packed_size = 256; // larger images are not packed
+		int padding = 1;           // transparent border around packed images, avoids filtering bleed
+		
+		SDL_AssetCache();
+		~SDL_AssetCache();
+		
+		// owns atlas pages and textures - a copy would free them twice
+		SDL_AssetCache(const SDL_AssetCache &) = delete;
+		SDL_AssetCache &operator=(const SDL_AssetCache &) = delete;
+		
+		void set_renderer(SDL_Renderer *r);
+		void set_bundle(const SDL_Bundle *b);
+		
+		SDL_TextureRegion load(const std::string &path);
+		std::vector<SDL_TextureRegion> load_sequence(const char *pattern, int first, int last);
+		SDL_TextureRegion insert(const std::string &key, SDL_Surface *surface); // existing key returns the cached region
+		
+		bool contains(const std::string &key) const;
+		void clear();
+		
+		int cache_hits() const { return hits; }
+		int cache_misses() const { return misses; }
+		int bundle_loads() const { return bundled; }
+		int page_count() const { return (int)pages.size(); }
+		int texture_count() const { return (int)(pages.size() + standalone.size()); }
+		
+	private:
+		bool pack(int w, int h, SDL_Texture **texture, SDL_Rect *rect);
+		bool add_page();
+	
+};
+
+#endif
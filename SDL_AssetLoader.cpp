@@ -0,0 +1,308 @@
+#include "SDL_AssetLoader.h"
+
+#include <algorithm>
+
+#include <stdio.h>
+
+
+SDL_AssetLoader::SDL_AssetLoader() {
+	
+	cache = NULL;
+	mixer = NULL;
+	bundle = NULL;
+	audio_held = false;
+	
+	stopping = false;
+	completed.store(NULL);
+	
+	total = 0;
+	finished.store(0);
+	
+}
+
+
+SDL_AssetLoader::~SDL_AssetLoader() {
+	shutdown();
+}
+
+
+void SDL_AssetLoader::set_targets(SDL_AssetCache *c, MIX_Mixer *m) {
+	cache = c;
+	mixer = m;
+}
+
+
+void SDL_AssetLoader::set_bundle(const SDL_Bundle *b) {
+	bundle = b;
+}
+
+
+SDL_AssetHandle SDL_AssetLoader::load_image(const std::string &path) {
+	
+	// already in flight - share the request
+	auto found = images.find(path);
+	if (found != images.end()) {
+		return found->second;
+	}
+	
+	// already uploaded - hand back a finished request without touching the workers
+	if (cache && cache->contains(path)) {
+		SDL_AssetHandle handle = std::make_shared<SDL_AssetRequest>();
+		handle->path = path;
+		handle->kind = SDL_ASSET_IMAGE;
+		handle->predecode = false;
+		handle->region = cache->load(path);
+		handle->audio = NULL;
+		handle->surface = NULL;
+		handle->next = NULL;
+		handle->state.store(SDL_LOAD_READY);
+		return handle;
+	}
+	
+	SDL_AssetHandle handle = submit(path, SDL_ASSET_IMAGE, false);
+	images[path] = handle;
+	
+	return handle;
+	
+}
+
+
+SDL_AssetHandle SDL_AssetLoader::load_audio(const std::string &path, bool predecode) {
+	
+	// decoders live in the mixer module - start it before a worker decodes
+	if (!audio_held) {
+		SDL_Runtime::instance().acquire_audio();
+		audio_held = true;
+	}
+	SDL_Runtime::instance().audio(); // on failure the worker reports the load error
+	
+	return submit(path, SDL_ASSET_AUDIO, predecode);
+}
+
+
+SDL_AssetHandle SDL_AssetLoader::submit(const std::string &path, SDL_AssetKind kind, bool predecode) {
+	
+	SDL_AssetHandle handle = std::make_shared<SDL_AssetRequest>();
+	handle->path = path;
+	handle->kind = kind;
+	handle->predecode = predecode;
+	handle->region = {NULL, {0.0f, 0.0f, 0.0f, 0.0f}};
+	handle->audio = NULL;
+	handle->surface = NULL;
+	handle->next = NULL;
+	handle->state.store(SDL_LOAD_PENDING);
+	
+	if (workers.empty()) {
+		start_workers();
+	}
+	
+	in_flight.push_back(handle);
+	total++;
+	
+	{
+		std::lock_guard<std::mutex> lock(jobs_mutex);
+		jobs.push_back(handle.get());
+	}
+	jobs_cv.notify_one();
+	
+	return handle;
+	
+}
+
+
+void SDL_AssetLoader::pump(uint64_t budget_ns) {
+	
+	uint64_t start = SDL_GetTicksNS();
+	
+	// take everything workers finished since last pump - stack is LIFO, reverse to keep request order
+	SDL_AssetRequest *list = completed.exchange(NULL, std::memory_order_acquire);
+	SDL_AssetRequest *ordered = NULL;
+	
+	while (list) {
+		SDL_AssetRequest *next = list->next;
+		list->next = ordered;
+		ordered = list;
+		list = next;
+	}
+	
+	for (; ordered; ordered = ordered->next) {
+		uploads.push_back(ordered);
+	}
+	
+	// texture uploads need the renderer - main thread only, at least one per call so loading always advances
+	while (!uploads.empty()) {
+		
+		SDL_AssetRequest *request = uploads.front();
+		uploads.pop_front();
+		
+		if (cache) {
+			request->region = cache->insert(request->path, request->surface);
+		}
+		
+		SDL_DestroySurface(request->surface);
+		request->surface = NULL;
+		
+		finish(request, request->region.texture ? SDL_LOAD_READY : SDL_LOAD_FAILED);
+		
+		if (SDL_GetTicksNS() - start >= budget_ns) {
+			break;
+		}
+	}
+	
+	// drop finished requests - callers holding a handle keep theirs alive
+	auto done = [](const SDL_AssetHandle &handle) {
+		int state = handle->state.load(std::memory_order_acquire);
+		return state == SDL_LOAD_READY || state == SDL_LOAD_FAILED;
+	};
+	
+	in_flight.erase(std::remove_if(in_flight.begin(), in_flight.end(), done), in_flight.end());
+	
+	for (auto it = images.begin(); it != images.end();) {
+		if (done(it->second)) {
+			it = images.erase(it);
+		}
+		else {
+			++it;
+		}
+	}
+	
+}
+
+
+void SDL_AssetLoader::shutdown() {
+	
+	{
+		std::lock_guard<std::mutex> lock(jobs_mutex);
+		stopping = true;
+		
+		for (SDL_AssetRequest *request : jobs) { // never started
+			finish(request, SDL_LOAD_FAILED);
+		}
+		jobs.clear();
+	}
+	jobs_cv.notify_all();
+	
+	for (std::thread &worker : workers) {
+		worker.join();
+	}
+	workers.clear();
+	
+	// decoded but never uploaded
+	SDL_AssetRequest *list = completed.exchange(NULL, std::memory_order_acquire);
+	for (; list; list = list->next) {
+		uploads.push_back(list);
+	}
+	
+	for (SDL_AssetRequest *request : uploads) {
+		SDL_DestroySurface(request->surface);
+		request->surface = NULL;
+		finish(request, SDL_LOAD_FAILED);
+	}
+	uploads.clear();
+	
+	in_flight.clear();
+	images.clear();
+	
+	if (audio_held) { // loaded audio belongs to callers now - they keep their own runtime reference
+		SDL_Runtime::instance().release_audio();
+		audio_held = false;
+	}
+	
+	stopping = false; // loader can be used again, workers restart on next request
+	
+}
+
+
+void SDL_AssetLoader::start_workers() {
+	
+	int count = thread_count;
+	if (count <= 0) {
+		count = SDL_GetNumLogicalCPUCores() - 1; // leave one core to the main loop
+	}
+	if (count < 1) {
+		count = 1;
+	}
+	
+	for (int i = 0; i < count; i++) {
+		workers.emplace_back(&SDL_AssetLoader::worker_loop, this);
+	}
+	
+}
+
+
+void SDL_AssetLoader::worker_loop() {
+	
+	while (true) {
+		
+		SDL_AssetRequest *request;
+		
+		{
+			std::unique_lock<std::mutex> lock(jobs_mutex);
+			jobs_cv.wait(lock, [this] { return stopping || !jobs.empty(); });
+			
+			if (stopping) {
+				return;
+			}
+			
+			request = jobs.front();
+			jobs.pop_front();
+		}
+		
+		if (request->kind == SDL_ASSET_AUDIO) {
+			
+			// no renderer involved - audio is finished here
+			request->audio = bundle ? bundle->audio(mixer, request->path, request->predecode) : NULL;
+			if (!request->audio) {
+				request->audio = MIX_LoadAudio(mixer, request->path.c_str(), request->predecode);
+			}
+			if (!request->audio) {
+				fprintf(stderr, "Error loading audio \"%s\": %s\n", request->path.c_str(), SDL_GetError());
+			}
+			finish(request, request->audio ? SDL_LOAD_READY : SDL_LOAD_FAILED);
+			continue;
+		}
+		
+		// bundled images skip decoding entirely - surface borrows the mapped RGBA32 pixels
+		SDL_Surface *surface = bundle ? bundle->surface(request->path) : NULL;
+		if (!surface) {
+			surface = IMG_Load(request->path.c_str());
+		}
+		
+		if (!surface) {
+			fprintf(stderr, "Error loading image \"%s\": %s\n", request->path.c_str(), SDL_GetError());
+			finish(request, SDL_LOAD_FAILED);
+			continue;
+		}
+		
+		// convert here so the main thread only copies pixels into the atlas
+		if (surface->format != SDL_PIXELFORMAT_RGBA32) {
+			SDL_Surface *rgba = SDL_ConvertSurface(surface, SDL_PIXELFORMAT_RGBA32);
+			if (rgba) {
+				SDL_DestroySurface(surface);
+				surface = rgba;
+			}
+		}
+		
+		request->surface = surface;
+		request->state.store(SDL_LOAD_DECODED, std::memory_order_release);
+		complete(request);
+	}
+	
+}
+
+
+void SDL_AssetLoader::complete(SDL_AssetRequest *request) {
+	
+	// lock-free push onto completion stack
+	SDL_AssetRequest *head = completed.load(std::memory_order_relaxed);
+	do {
+		request->next = head;
+	} while (!completed.compare_exchange_weak(head, request, std::memory_order_release, std::memory_order_relaxed));
+	
+}
+
+
+void SDL_AssetLoader::finish(SDL_AssetRequest *request, SDL_LoadState state) {
+	request->state.store(state, std::memory_order_release);
+	finished.fetch_add(1);
+}
@@ -0,0 +1,108 @@
+#ifndef SDL_ASSETLOADER_H
+#define SDL_ASSETLOADER_H
+
+#include <SDL3/SDL.h>
+#include <SDL3_image/SDL_image.h>
+#include <SDL3_mixer/SDL_mixer.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "SDL_AssetCache.h"
+#include "SDL_Runtime.h"
+
+enum SDL_LoadState {
+	SDL_LOAD_PENDING,  // queued or decoding on a worker
+	SDL_LOAD_DECODED,  // decoded, waiting for upload on main thread
+	SDL_LOAD_READY,    // region / audio usable
+	SDL_LOAD_FAILED
+};
+
+enum SDL_AssetKind {
+	SDL_ASSET_IMAGE,
+	SDL_ASSET_AUDIO
+};
+
+// Shared state of one background load - poll state, use region or audio once ready
+struct SDL_AssetRequest {
+	std::string path;
+	SDL_AssetKind kind;
+	bool predecode;
+	std::atomic<int> state;
+	
+	SDL_TextureRegion region; // images - valid when ready
+	MIX_Audio *audio;         // audio - valid when ready, owned by caller
+	
+	SDL_Surface *surface;     // decoded pixels in transit to the main thread
+	SDL_AssetRequest *next;   // link in completion stack
+	
+	bool ready() const { return state.load(std::memory_order_acquire) == SDL_LOAD_READY; }
+	bool failed() const { return state.load(std::memory_order_acquire) == SDL_LOAD_FAILED; }
+};
+
+typedef std::shared_ptr<SDL_AssetRequest> SDL_AssetHandle;
+
+// Decodes images and audio on a pool of worker threads. Decoded surfaces come
+// back through a lock-free stack and are uploaded into an SDL_AssetCache by
+// pump() on the main thread, within a time budget per call. Workers start on
+// the first request.
+class SDL_AssetLoader {
+	
+	SDL_AssetCache *cache;
+	MIX_Mixer *mixer;
+	const SDL_Bundle *bundle; // read by workers - set before the first request
+	bool audio_held;          // runtime audio reference, taken with the first audio request
+	
+	// work queue - only touched when requests are issued or picked up
+	std::vector<std::thread> workers;
+	std::deque<SDL_AssetRequest*> jobs;
+	std::mutex jobs_mutex;
+	std::condition_variable jobs_cv;
+	bool stopping;
+	
+	// completed decodes, pushed by workers and drained by pump()
+	std::atomic<SDL_AssetRequest*> completed;
+	
+	// main thread only
+	std::vector<SDL_AssetHandle> in_flight;                  // keeps requests alive while workers use them
+	std::unordered_map<std::string, SDL_AssetHandle> images; // dedupes images requested twice before upload
+	std::deque<SDL_AssetRequest*> uploads;                   // decoded, not yet uploaded
+	
+	int total;
+	std::atomic<int> finished;
+	
+	public:
+		int thread_count = 0; // 0 = one less than logical cores (at least one)
+		
+		SDL_AssetLoader();
+		~SDL_AssetLoader();
+		
+		void set_targets(SDL_AssetCache *c, MIX_Mixer *m);
+		void set_bundle(const SDL_Bundle *b);
+		
+		SDL_AssetHandle load_image(const std::string &path);
+		SDL_AssetHandle load_audio(const std::string &path, bool predecode = true);
+		
+		void pump(uint64_t budget_ns);
+		void shutdown();
+		
+		bool idle() const { return finished.load() == total && uploads.empty(); }
+		float progress() const { return total ? (float)finished.load() / (float)total : 1.0f; }
+		
+	private:
+		SDL_AssetHandle submit(const std::string &path, SDL_AssetKind kind, bool predecode);
+		void start_workers();
+		void worker_loop();
+		void complete(SDL_AssetRequest *request);
+		void finish(SDL_AssetRequest *request, SDL_LoadState state);
+	
+};
+
+#endif
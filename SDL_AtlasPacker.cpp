@@ -0,0 +1,135 @@
+#include "SDL_AtlasPacker.h"
+
+
+SDL_AtlasPacker::SDL_AtlasPacker(int w, int h) {
+	reset(w, h);
+}
+
+
+void SDL_AtlasPacker::reset(int w, int h) {
+	
+	width = w;
+	height = h;
+	used_area = 0;
+	
+	skyline.clear();
+	skyline.push_back({0, 0, w}); // empty page - one segment along the bottom
+	
+}
+
+
+bool SDL_AtlasPacker::pack(int w, int h, SDL_Rect *out) {
+	
+	if (w <= 0 || h <= 0 || w > width || h > height) {
+		return false;
+	}
+	
+	// find segment where rect top ends lowest, ties broken by narrowest segment
+	int best_index = -1;
+	int best_top = height + 1;
+	int best_w = width + 1;
+	int best_y = 0;
+	
+	for (size_t i = 0; i < skyline.size(); i++) {
+		int y;
+		if (fits(i, w, h, &y)) {
+			if (y + h < best_top || (y + h == best_top && skyline[i].w < best_w)) {
+				best_index = (int)i;
+				best_top = y + h;
+				best_w = skyline[i].w;
+				best_y = y;
+			}
+		}
+	}
+	
+	if (best_index < 0) { // page full
+		return false;
+	}
+	
+	out->x = skyline[best_index].x;
+	out->y = best_y;
+	out->w = w;
+	out->h = h;
+	
+	// raise skyline over placed rect
+	skyline.insert(skyline.begin() + best_index, {out->x, best_y + h, w});
+	
+	// trim or remove segments now covered by the new one
+	for (size_t i = best_index + 1; i < skyline.size(); i++) {
+		
+		const Segment &prev = skyline[i - 1];
+		int prev_end = prev.x + prev.w;
+		
+		if (skyline[i].x >= prev_end) {
+			break;
+		}
+		
+		int shrink = prev_end - skyline[i].x;
+		skyline[i].x += shrink;
+		skyline[i].w -= shrink;
+		
+		if (skyline[i].w > 0) {
+			break;
+		}
+		
+		skyline.erase(skyline.begin() + i);
+		i--;
+	}
+	
+	// merge neighbours at equal height
+	for (size_t i = 0; i + 1 < skyline.size(); i++) {
+		if (skyline[i].y == skyline[i + 1].y) {
+			skyline[i].w += skyline[i + 1].w;
+			skyline.erase(skyline.begin() + i + 1);
+			i--;
+		}
+	}
+	
+	used_area += w * h;
+	return true;
+	
+}
+
+
+float SDL_AtlasPacker::occupancy() const {
+	
+	if (width <= 0 || height <= 0) {
+		return 0.0f;
+	}
+	
+	return (float)used_area / ((float)width * (float)height);
+}
+
+
+bool SDL_AtlasPacker::fits(size_t index, int w, int h, int *y) const {
+	
+	// rect starting at segment index rests on the highest segment it spans
+	int x = skyline[index].x;
+	if (x + w > width) {
+		return false;
+	}
+	
+	int top = 0;
+	int remaining = w;
+	
+	for (size_t i = index; remaining > 0; i++) {
+		
+		if (i >= skyline.size()) {
+			return false;
+		}
+		
+		if (skyline[i].y > top) {
+			top = skyline[i].y;
+		}
+		
+		if (top + h > height) {
+			return false;
+		}
+		
+		remaining -= skyline[i].w;
+	}
+	
+	*y = top;
+	return true;
+	
+}
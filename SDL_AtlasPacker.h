@@ -0,0 +1,40 @@
+#ifndef SDL_ATLASPACKER_H
+#define SDL_ATLASPACKER_H
+
+#include <SDL3/SDL.h>
+
+#include <vector>
+
+// Skyline bottom-left rectangle packer for atlas pages. Tracks the top edge
+// of everything placed so far as a list of horizontal segments and puts each
+// new rectangle where its top ends up lowest.
+class SDL_AtlasPacker {
+	
+	struct Segment {
+		int x;
+		int y;
+		int w;
+	};
+	
+	int width;
+	int height;
+	int used_area;
+	
+	std::vector<Segment> skyline;
+	
+	public:
+		SDL_AtlasPacker(int w = 0, int h = 0);
+		
+		void reset(int w, int h);
+		bool pack(int w, int h, SDL_Rect *out);
+		
+		int get_width() const { return width; }
+		int get_height() const { return height; }
+		float occupancy() const; // fraction of page area covered by packed rects
+		
+	private:
+		bool fits(size_t index, int w, int h, int *y) const;
+	
+};
+
+#endif
@@ -0,0 +1,400 @@
+#include "SDL_Bundle.h"
+
+#include <algorithm>
+
+#include <stdio.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+// offset and length both come from the file - compare by subtraction so nothing can wrap
+static bool span_fits(Uint64 offset, Uint64 length, Uint64 size) {
+	return offset <= size && length <= size - offset;
+}
+
+
+SDL_Bundle::SDL_Bundle() {
+	
+	data = NULL;
+	data_size = 0;
+	mapped = false;
+	
+	entries = NULL;
+	entry_count = 0;
+	
+}
+
+
+SDL_Bundle::~SDL_Bundle() {
+	close();
+}
+
+
+bool SDL_Bundle::open(const char *path) {
+	
+	close();
+	
+	if (!map_file(path)) {
+		fprintf(stderr, "Error opening bundle \"%s\": %s\n", path, SDL_GetError());
+		return false;
+	}
+	
+	// header and index are used in place - fields are stored in host (little endian) order
+	const SDL_BundleHeader *header = (const SDL_BundleHeader*)data;
+	
+	bool valid = data_size >= sizeof(SDL_BundleHeader)
+		&& header->magic == BUNDLE_MAGIC
+		&& header->version == BUNDLE_VERSION
+		&& header->index_offset % alignof(SDL_BundleEntry) == 0
+		&& span_fits(header->index_offset, (Uint64)header->entry_count * sizeof(SDL_BundleEntry), data_size)
+		&& span_fits(header->names_offset, header->names_size, data_size)
+		&& header->names_size > 0
+		&& data[header->names_offset + header->names_size - 1] == '\0';
+	
+	if (!valid) {
+		fprintf(stderr, "Error opening bundle \"%s\": not a bundle or wrong version.\n", path);
+		close();
+		return false;
+	}
+	
+	entries = (const SDL_BundleEntry*)(data + header->index_offset);
+	entry_count = header->entry_count;
+	
+	index.reserve(entry_count);
+	
+	for (Uint32 i = 0; i < entry_count; i++) {
+		
+		const SDL_BundleEntry &entry = entries[i];
+		
+		bool fits = span_fits(entry.offset, entry.size, data_size) && entry.name_offset < header->names_size;
+		if (fits && entry.kind == SDL_BUNDLE_IMAGE) {
+			fits = entry.width > 0 && entry.height > 0 && entry.pitch > 0
+				&& (Sint64)entry.pitch >= (Sint64)entry.width * 4
+				&& (Uint64)entry.pitch * (Uint64)entry.height <= entry.size;
+		}
+		
+		if (!fits) {
+			fprintf(stderr, "Error opening bundle \"%s\": entry %u is out of bounds.\n", path, i);
+			close();
+			return false;
+		}
+		
+		index[name(&entry)] = i;
+	}
+	
+	return true;
+	
+}
+
+
+void SDL_Bundle::close() {
+	
+	index.clear();
+	entries = NULL;
+	entry_count = 0;
+	
+	unmap_file();
+	
+}
+
+
+const SDL_BundleEntry *SDL_Bundle::find(const std::string &name) const {
+	
+	auto found = index.find(name);
+	if (found == index.end()) {
+		return NULL;
+	}
+	
+	return &entries[found->second];
+}
+
+
+const char *SDL_Bundle::name(const SDL_BundleEntry *entry) const {
+	const SDL_BundleHeader *header = (const SDL_BundleHeader*)data;
+	return (const char*)(data + header->names_offset + entry->name_offset);
+}
+
+
+SDL_Surface *SDL_Bundle::surface(const std::string &name) const {
+	
+	const SDL_BundleEntry *entry = find(name);
+	if (!entry || entry->kind != SDL_BUNDLE_IMAGE) {
+		return NULL;
+	}
+	
+	// surface borrows the mapped pixels - the mapping is read-only, so the surface must never be drawn into
+	SDL_Surface *surface = SDL_CreateSurfaceFrom(entry->width, entry->height, SDL_PIXELFORMAT_RGBA32, (void*)blob(entry), entry->pitch);
+	if (!surface) {
+		fprintf(stderr, "Error creating surface for \"%s\": %s\n", name.c_str(), SDL_GetError());
+	}
+	
+	return surface;
+	
+}
+
+
+MIX_Audio *SDL_Bundle::audio(MIX_Mixer *mixer, const std::string &name, bool predecode) const {
+	
+	const SDL_BundleEntry *entry = find(name);
+	if (!entry || entry->kind != SDL_BUNDLE_AUDIO) {
+		return NULL;
+	}
+	
+	// streamed (not predecoded) audio keeps reading from the mapping while it plays
+	SDL_IOStream *io = SDL_IOFromConstMem(blob(entry), (size_t)entry->size);
+	MIX_Audio *audio = io ? MIX_LoadAudio_IO(mixer, io, predecode, true) : NULL;
+	
+	if (!audio) {
+		fprintf(stderr, "Error loading audio \"%s\" from bundle: %s\n", name.c_str(), SDL_GetError());
+	}
+	
+	return audio;
+	
+}
+
+
+bool SDL_Bundle::map_file(const char *path) {
+	
+#ifdef _WIN32
+	HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (file != INVALID_HANDLE_VALUE) {
+		
+		LARGE_INTEGER size;
+		HANDLE mapping = NULL;
+		
+		if (GetFileSizeEx(file, &size) && size.QuadPart > 0) {
+			mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+		}
+		
+		if (mapping) {
+			data = (const Uint8*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+			data_size = (size_t)size.QuadPart;
+			CloseHandle(mapping); // view keeps the mapping alive
+		}
+		
+		CloseHandle(file);
+	}
+#else
+	int fd = ::open(path, O_RDONLY);
+	if (fd >= 0) {
+		
+		struct stat info;
+		
+		if (fstat(fd, &info) == 0 && info.st_size > 0) {
+			void *view = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+			if (view != MAP_FAILED) {
+				data = (const Uint8*)view;
+				data_size = (size_t)info.st_size;
+			}
+		}
+		
+		::close(fd); // mapping stays valid after the descriptor is closed
+	}
+#endif
+	
+	if (data) {
+		mapped = true;
+		return true;
+	}
+	
+	// no mapping available (or empty file) - read it whole, same layout either way
+	data = (const Uint8*)SDL_LoadFile(path, &data_size);
+	mapped = false;
+	
+	return data != NULL;
+	
+}
+
+
+void SDL_Bundle::unmap_file() {
+	
+	if (!data) {
+		return;
+	}
+	
+	if (!mapped) {
+		SDL_free((void*)data);
+	}
+	else {
+#ifdef _WIN32
+		UnmapViewOfFile(data);
+#else
+		munmap((void*)data, data_size);
+#endif
+	}
+	
+	data = NULL;
+	data_size = 0;
+	mapped = false;
+	
+}
+
+
+bool SDL_BundleWriter::add_image(const std::string &name, SDL_Surface *surface) {
+	
+	if (std::find(names.begin(), names.end(), name) != names.end()) {
+		fprintf(stderr, "Error adding \"%s\" to bundle: name already used.\n", name.c_str());
+		return false;
+	}
+	
+	// store in the atlas format so loading is a plain upload
+	SDL_Surface *rgba = surface;
+	if (surface->format != SDL_PIXELFORMAT_RGBA32) {
+		rgba = SDL_ConvertSurface(surface, SDL_PIXELFORMAT_RGBA32);
+		if (!rgba) {
+			fprintf(stderr, "Error converting \"%s\": %s\n", name.c_str(), SDL_GetError());
+			return false;
+		}
+	}
+	
+	int row = rgba->w * 4; // tight rows - one contiguous block per image
+	std::vector<Uint8> pixels((size_t)row * rgba->h);
+	
+	for (int y = 0; y < rgba->h; y++) {
+		memcpy(&pixels[(size_t)y * row], (const Uint8*)rgba->pixels + (size_t)y * rgba->pitch, row);
+	}
+	
+	SDL_BundleEntry entry = {};
+	entry.kind = SDL_BUNDLE_IMAGE;
+	entry.width = rgba->w;
+	entry.height = rgba->h;
+	entry.pitch = row;
+	
+	if (rgba != surface) {
+		SDL_DestroySurface(rgba);
+	}
+	
+	entries.push_back(entry);
+	names.push_back(name);
+	blobs.push_back(std::move(pixels));
+	
+	return true;
+	
+}
+
+
+bool SDL_BundleWriter::add_image_file(const std::string &name, const char *path) {
+	
+	SDL_Surface *surface = IMG_Load(path);
+	if (!surface) {
+		fprintf(stderr, "Error loading image \"%s\": %s\n", path, SDL_GetError());
+		return false;
+	}
+	
+	bool added = add_image(name, surface);
+	SDL_DestroySurface(surface);
+	
+	return added;
+	
+}
+
+
+bool SDL_BundleWriter::add_audio_file(const std::string &name, const char *path) {
+	
+	if (std::find(names.begin(), names.end(), name) != names.end()) {
+		fprintf(stderr, "Error adding \"%s\" to bundle: name already used.\n", name.c_str());
+		return false;
+	}
+	
+	// kept in its source encoding - the mixer decodes (or streams) it at load time
+	size_t size = 0;
+	Uint8 *bytes = (Uint8*)SDL_LoadFile(path, &size);
+	if (!bytes) {
+		fprintf(stderr, "Error loading audio \"%s\": %s\n", path, SDL_GetError());
+		return false;
+	}
+	
+	SDL_BundleEntry entry = {};
+	entry.kind = SDL_BUNDLE_AUDIO;
+	
+	entries.push_back(entry);
+	names.push_back(name);
+	blobs.push_back(std::vector<Uint8>(bytes, bytes + size));
+	
+	SDL_free(bytes);
+	return true;
+	
+}
+
+
+bool SDL_BundleWriter::write(const char *path) const {
+	
+	auto align = [](Uint64 offset) { return (offset + BUNDLE_ALIGN - 1) / BUNDLE_ALIGN * BUNDLE_ALIGN; };
+	
+	// lay out blobs after the header, then index and names
+	std::vector<SDL_BundleEntry> index = entries;
+	std::string name_block;
+	Uint64 offset = align(sizeof(SDL_BundleHeader));
+	
+	for (size_t i = 0; i < index.size(); i++) {
+		index[i].offset = offset;
+		index[i].size = blobs[i].size();
+		index[i].name_offset = (Uint32)name_block.size();
+		name_block.append(names[i]);
+		name_block.push_back('\0');
+		offset = align(offset + blobs[i].size());
+	}
+	
+	if (name_block.empty()) {
+		name_block.push_back('\0'); // keeps the terminator check in open() valid for empty bundles
+	}
+	
+	SDL_BundleHeader header = {};
+	header.magic = BUNDLE_MAGIC;
+	header.version = BUNDLE_VERSION;
+	header.entry_count = (Uint32)index.size();
+	header.index_offset = offset;
+	header.names_offset = offset + index.size() * sizeof(SDL_BundleEntry);
+	header.names_size = name_block.size();
+	
+	SDL_IOStream *io = SDL_IOFromFile(path, "wb");
+	if (!io) {
+		fprintf(stderr, "Error writing bundle \"%s\": %s\n", path, SDL_GetError());
+		return false;
+	}
+	
+	static const Uint8 zeros[BUNDLE_ALIGN] = {};
+	Uint64 written = 0;
+	bool ok = true;
+	
+	auto put = [&](const void *bytes, size_t size) {
+		if (size && SDL_WriteIO(io, bytes, size) != size) {
+			ok = false;
+		}
+		written += size;
+	};
+	
+	put(&header, sizeof(header));
+	
+	for (size_t i = 0; i < index.size() && ok; i++) {
+		put(zeros, (size_t)(index[i].offset - written));
+		put(blobs[i].data(), blobs[i].size());
+	}
+	
+	put(zeros, (size_t)(header.index_offset - written));
+	put(index.data(), index.size() * sizeof(SDL_BundleEntry));
+	put(name_block.data(), name_block.size());
+	
+	if (!SDL_CloseIO(io) || !ok) {
+		fprintf(stderr, "Error writing bundle \"%s\": %s\n", path, SDL_GetError());
+		return false;
+	}
+	
+	return true;
+	
+}
+
+
+void SDL_BundleWriter::clear() {
+	entries.clear();
+	names.clear();
+	blobs.clear();
+}
@@ -0,0 +1,101 @@
+#ifndef SDL_BUNDLE_H
+#define SDL_BUNDLE_H
+
+#include <SDL3/SDL.h>
+#include <SDL3_image/SDL_image.h>
+#include <SDL3_mixer/SDL_mixer.h>
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#define BUNDLE_MAGIC 0x424C4453 // "SDLB" read as little endian
+#define BUNDLE_VERSION 1
+#define BUNDLE_ALIGN 64         // every blob starts on a cache line, rows stay aligned for upload copies
+
+enum SDL_BundleKind {
+	SDL_BUNDLE_IMAGE, // RGBA32 pixels, pitch = width * 4
+	SDL_BUNDLE_AUDIO  // audio file bytes in their source encoding
+};
+
+// File layout: header | blobs (each BUNDLE_ALIGN aligned) | entry index | names.
+// All fields little endian, names are null terminated.
+struct SDL_BundleHeader {
+	Uint32 magic;
+	Uint32 version;
+	Uint32 entry_count;
+	Uint32 reserved;
+	Uint64 index_offset; // SDL_BundleEntry[entry_count]
+	Uint64 names_offset;
+	Uint64 names_size;
+};
+
+struct SDL_BundleEntry {
+	Uint64 offset;      // blob start from beginning of file
+	Uint64 size;        // blob size in bytes
+	Uint32 name_offset; // into names block
+	Uint32 kind;        // SDL_BundleKind
+	Sint32 width;       // images only
+	Sint32 height;
+	Sint32 pitch;
+	Uint32 reserved;
+};
+
+// Read-only view of a packed asset bundle. The file is memory-mapped once;
+// surfaces and audio streams point straight into the mapping, so nothing is
+// decoded or copied until a texture upload. Anything created from the bundle
+// must be released before close().
+class SDL_Bundle {
+	
+	const Uint8 *data;
+	size_t data_size;
+	bool mapped; // false when the file had to be read into memory instead
+	
+	const SDL_BundleEntry *entries;
+	Uint32 entry_count;
+	std::unordered_map<std::string, Uint32> index; // entry name -> position in entries
+	
+	public:
+		SDL_Bundle();
+		~SDL_Bundle();
+		
+		bool open(const char *path);
+		void close();
+		
+		bool is_open() const { return data != NULL; }
+		int size() const { return (int)entry_count; }
+		
+		const SDL_BundleEntry *find(const std::string &name) const;
+		const char *name(const SDL_BundleEntry *entry) const;
+		const void *blob(const SDL_BundleEntry *entry) const { return data + entry->offset; }
+		
+		// NULL when name is not in the bundle (no error printed) - callers fall back to loose files
+		SDL_Surface *surface(const std::string &name) const;
+		MIX_Audio *audio(MIX_Mixer *mixer, const std::string &name, bool predecode = true) const;
+	
+	private:
+		bool map_file(const char *path);
+		void unmap_file();
+	
+};
+
+// Builds a bundle in memory and writes it out - used by SDL_BundlePacker and the benchmarks.
+class SDL_BundleWriter {
+	
+	std::vector<SDL_BundleEntry> entries;
+	std::vector<std::string> names;
+	std::vector<std::vector<Uint8>> blobs;
+	
+	public:
+		bool add_image(const std::string &name, SDL_Surface *surface);
+		bool add_image_file(const std::string &name, const char *path);
+		bool add_audio_file(const std::string &name, const char *path);
+		
+		bool write(const char *path) const;
+		
+		int size() const { return (int)entries.size(); }
+		void clear();
+	
+};
+
+#endif
@@ -0,0 +1,191 @@
+#include "SDL_JobPool.h"
+
+
+thread_local SDL_JobPool *SDL_JobPool::worker_pool = NULL;
+thread_local int SDL_JobPool::worker_index = -1;
+
+
+SDL_JobPool::SDL_JobPool() {
+	
+	queued.store(0);
+	stopping = false;
+	
+	thread_count = JOBPOOL_AUTO;
+	next_queue.store(0);
+	
+}
+
+
+SDL_JobPool::~SDL_JobPool() {
+	shutdown();
+}
+
+
+void SDL_JobPool::set_threads(int count) {
+	
+	shutdown();
+	
+	thread_count = count < 0 ? JOBPOOL_AUTO : count;
+	
+}
+
+
+void SDL_JobPool::shutdown() {
+	
+	{
+		std::lock_guard<std::mutex> lock(sleep_mutex);
+		stopping = true;
+	}
+	sleep_cv.notify_all();
+	
+	for (std::thread &worker : workers) {
+		worker.join();
+	}
+	workers.clear();
+	queues.clear();
+	
+	stopping = false;
+	
+}
+
+
+void SDL_JobPool::start() {
+	
+	if (thread_count == JOBPOOL_AUTO) {
+		thread_count = SDL_GetNumLogicalCPUCores() - 1; // calling thread takes part too
+	}
+	if (thread_count < 0) {
+		thread_count = 0;
+	}
+	
+	// queue thread_count is shared by threads outside the pool
+	for (int i = 0; i <= thread_count; i++) {
+		queues.emplace_back(new Queue());
+	}
+	
+	for (int i = 0; i < thread_count; i++) {
+		workers.emplace_back(&SDL_JobPool::worker_loop, this, i);
+	}
+	
+}
+
+
+void SDL_JobPool::run_range(void (*fn)(void *, int, int), void *data, int count, int grain) {
+	
+	if (count <= 0) {
+		return;
+	}
+	if (grain < 1) {
+		grain = 1;
+	}
+	
+	if (queues.empty()) {
+		start();
+	}
+	
+	// single chunk or no workers - no point in queueing
+	if (count <= grain || thread_count == 0) {
+		fn(data, 0, count);
+		return;
+	}
+	
+	int chunks = (count + grain - 1) / grain;
+	std::atomic<int> remaining(chunks);
+	
+	// spread chunks round robin so every worker starts with local work
+	for (int c = 0; c < chunks; c++) {
+		int begin = c * grain;
+		int end = begin + grain < count ? begin + grain : count;
+		push({fn, data, begin, end, &remaining});
+	}
+	
+	{
+		std::lock_guard<std::mutex> lock(sleep_mutex);
+	}
+	sleep_cv.notify_all();
+	
+	// help instead of blocking - also keeps nested parallel_for from deadlocking
+	int home = worker_pool == this ? worker_index : thread_count;
+	while (remaining.load(std::memory_order_acquire) > 0) {
+		if (!run_one(home)) {
+			std::this_thread::yield();
+		}
+	}
+	
+}
+
+
+void SDL_JobPool::push(const Job &job) {
+	
+	unsigned index = next_queue.fetch_add(1, std::memory_order_relaxed) % (unsigned)queues.size();
+	
+	{
+		std::lock_guard<std::mutex> lock(queues[index]->mutex);
+		queues[index]->jobs.push_back(job);
+	}
+	queued.fetch_add(1, std::memory_order_release);
+	
+}
+
+
+bool SDL_JobPool::run_one(int home) {
+	
+	Job job;
+	bool found = false;
+	
+	// own queue from the back (most recently pushed, still warm in cache)
+	{
+		Queue &own = *queues[home];
+		std::lock_guard<std::mutex> lock(own.mutex);
+		if (!own.jobs.empty()) {
+			job = own.jobs.back();
+			own.jobs.pop_back();
+			found = true;
+		}
+	}
+	
+	// steal from the front of the others
+	for (size_t i = 1; !found && i < queues.size(); i++) {
+		Queue &victim = *queues[(home + i) % queues.size()];
+		std::lock_guard<std::mutex> lock(victim.mutex);
+		if (!victim.jobs.empty()) {
+			job = victim.jobs.front();
+			victim.jobs.pop_front();
+			found = true;
+		}
+	}
+	
+	if (!found) {
+		return false;
+	}
+	
+	queued.fetch_sub(1, std::memory_order_relaxed);
+	
+	job.fn(job.data, job.begin, job.end);
+	job.remaining->fetch_sub(1, std::memory_order_release);
+	
+	return true;
+	
+}
+
+
+void SDL_JobPool::worker_loop(int index) {
+	
+	worker_pool = this;
+	worker_index = index;
+	
+	while (true) {
+		
+		if (run_one(index)) {
+			continue;
+		}
+		
+		std::unique_lock<std::mutex> lock(sleep_mutex);
+		sleep_cv.wait(lock, [this] { return stopping || queued.load(std::memory_order_acquire) > 0; });
+		
+		if (stopping) {
+			return;
+		}
+	}
+	
+}
@@ -0,0 +1,84 @@
+#ifndef SDL_JOBPOOL_H
+#define SDL_JOBPOOL_H
+
+#include <SDL3/SDL.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#define JOBPOOL_AUTO -1 // set_threads() - one worker less than logical cores
+
+// Work-stealing thread pool for data-parallel loops. parallel_for() splits a
+// range into chunks spread over the worker queues; idle workers steal from
+// the front of other queues while owners pop from the back. The calling
+// thread helps until its range is done, so nested calls from inside a job
+// are fine. Workers start on first use.
+class SDL_JobPool {
+	
+	struct Job {
+		void (*fn)(void *data, int begin, int end);
+		void *data;
+		int begin;
+		int end;
+		std::atomic<int> *remaining; // chunks of the owning parallel_for still running
+	};
+	
+	struct Queue {
+		std::mutex mutex;
+		std::deque<Job> jobs;
+	};
+	
+	std::vector<std::thread> workers;
+	std::vector<std::unique_ptr<Queue>> queues; // one per worker, plus one for external callers
+	
+	std::mutex sleep_mutex;
+	std::condition_variable sleep_cv;
+	std::atomic<int> queued;
+	bool stopping;
+	
+	int thread_count;
+	std::atomic<unsigned> next_queue;
+	
+	public:
+		SDL_JobPool();
+		~SDL_JobPool();
+		
+		void set_threads(int count); // JOBPOOL_AUTO (default), or worker count - 0 runs everything inline on the caller; restarts workers
+		int threads() const { return thread_count; }
+		
+		template <typename F>
+		void parallel_for(int count, int grain, F &&fn);
+		
+		void shutdown();
+		
+	private:
+		void start();
+		void push(const Job &job);
+		bool run_one(int home);
+		void worker_loop(int index);
+		void run_range(void (*fn)(void *, int, int), void *data, int count, int grain);
+		
+		static thread_local SDL_JobPool *worker_pool; // pool the current thread works for, NULL outside
+		static thread_local int worker_index;
+	
+};
+
+
+template <typename F>
+void SDL_JobPool::parallel_for(int count, int grain, F &&fn) {
+	
+	// fn(begin, end) runs on some thread for every chunk; it outlives all chunks
+	// because run_range() only returns once they are done
+	auto trampoline = [](void *data, int begin, int end) {
+		(*(typename std::remove_reference<F>::type *)data)(begin, end);
+	};
+	
+	run_range(trampoline, (void *)&fn, count, grain);
+}
+
+#endif
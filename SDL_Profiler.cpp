@@ -0,0 +1,291 @@
+#include "SDL_Profiler.h"
+
+#include <algorithm>
+
+#include <stdio.h>
+#include <string.h>
+
+
+SDL_Profiler::SDL_Profiler() {
+	
+	for (int i = 0; i < PROFILER_RING_SIZE; i++) {
+		ring[i].sequence.store(0, std::memory_order_relaxed);
+	}
+	
+	write_index.store(0);
+	read_index = 0;
+	
+	zone_count.store(0);
+	
+}
+
+
+SDL_Profiler &SDL_Profiler::instance() {
+	static SDL_Profiler profiler; // large - lives in static storage, built on first use
+	return profiler;
+}
+
+
+uint16_t SDL_Profiler::zone_id(const char *name) {
+	
+	std::lock_guard<std::mutex> lock(zones_mutex);
+	
+	int count = zone_count.load();
+	
+	for (int i = 0; i < count; i++) { // same name from several call sites shares a zone
+		if (strcmp(zones[i].name, name) == 0) {
+			return (uint16_t)i;
+		}
+	}
+	
+	if (count >= PROFILER_MAX_ZONES) {
+		fprintf(stderr, "Error - profiler zone limit reached, \"%s\" merged into last zone.\n", name);
+		return PROFILER_MAX_ZONES - 1;
+	}
+	
+	Zone &zone = zones[count];
+	zone.name = name;
+	zone.next = 0;
+	zone.count = 0;
+	
+	zone_count.store(count + 1); // publish after zone is initialized
+	
+	return (uint16_t)count;
+	
+}
+
+
+void SDL_Profiler::record(uint16_t zone, uint64_t start_ns, uint64_t end_ns) {
+	
+	// claim a slot, fill it, then publish with sequence - readers skip slots whose sequence doesn't match
+	uint64_t index = write_index.fetch_add(1, std::memory_order_relaxed);
+	Event &event = ring[index & (PROFILER_RING_SIZE - 1)];
+	
+	event.sequence.store(0, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release); // invalidation is visible before any payload store
+	
+	event.zone.store(zone, std::memory_order_relaxed);
+	event.thread.store((uint64_t)SDL_GetCurrentThreadID(), std::memory_order_relaxed);
+	event.start_ns.store(start_ns, std::memory_order_relaxed);
+	event.end_ns.store(end_ns, std::memory_order_relaxed);
+	
+	event.sequence.store(index + 1, std::memory_order_release);
+	
+}
+
+
+bool SDL_Profiler::read(uint64_t index, Sample &sample) const {
+	
+	const Event &event = ring[index & (PROFILER_RING_SIZE - 1)];
+	if (event.sequence.load(std::memory_order_acquire) != index + 1) {
+		return false; // empty, still being written or already reused
+	}
+	
+	sample.zone = event.zone.load(std::memory_order_relaxed);
+	sample.thread = event.thread.load(std::memory_order_relaxed);
+	sample.start_ns = event.start_ns.load(std::memory_order_relaxed);
+	sample.end_ns = event.end_ns.load(std::memory_order_relaxed);
+	
+	// pairs with the writer's fence - if the slot was reused during the copy, the sequence has changed
+	std::atomic_thread_fence(std::memory_order_acquire);
+	if (event.sequence.load(std::memory_order_relaxed) != index + 1) {
+		return false;
+	}
+	
+	return sample.zone < PROFILER_MAX_ZONES;
+	
+}
+
+
+// zone names are arbitrary strings - quote them for JSON
+static void write_json_string(FILE *file, const char *text) {
+	
+	fputc('"', file);
+	
+	for (const unsigned char *c = (const unsigned char*)text; *c; c++) {
+		if (*c == '"' || *c == '\\') {
+			fputc('\\', file);
+			fputc(*c, file);
+		}
+		else if (*c < 0x20) {
+			fprintf(file, "\\u%04x", *c);
+		}
+		else {
+			fputc(*c, file);
+		}
+	}
+	
+	fputc('"', file);
+	
+}
+
+
+// quoted (with quotes doubled) only when the name holds a separator, quote or line break
+static void write_csv_field(FILE *file, const char *text) {
+	
+	if (!strpbrk(text, ",\"\r\n")) {
+		fputs(text, file);
+		return;
+	}
+	
+	fputc('"', file);
+	
+	for (const char *c = text; *c; c++) {
+		if (*c == '"') {
+			fputc('"', file);
+		}
+		fputc(*c, file);
+	}
+	
+	fputc('"', file);
+	
+}
+
+
+void SDL_Profiler::end_frame() {
+	
+	uint64_t end = write_index.load(std::memory_order_acquire);
+	
+	// lapped by writers - skip what was overwritten
+	if (end - read_index > PROFILER_RING_SIZE) {
+		read_index = end - PROFILER_RING_SIZE;
+	}
+	
+	for (; read_index < end; read_index++) {
+		
+		const Event &event = ring[read_index & (PROFILER_RING_SIZE - 1)];
+		if (event.sequence.load(std::memory_order_acquire) != read_index + 1) {
+			break; // still being written - pick up next frame
+		}
+		
+		Sample sample;
+		if (!read(read_index, sample)) {
+			continue; // overwritten while reading
+		}
+		
+		Zone &zone = zones[sample.zone];
+		zone.window[zone.next] = sample.end_ns - sample.start_ns;
+		zone.next = (zone.next + 1) % PROFILER_WINDOW;
+		if (zone.count < PROFILER_WINDOW) {
+			zone.count++;
+		}
+	}
+	
+}
+
+
+SDL_ZoneStats SDL_Profiler::stats(int zone) const {
+	
+	const Zone &z = zones[zone];
+	SDL_ZoneStats result = {z.name, (uint64_t)z.count, 0.0, 0.0, 0.0};
+	
+	if (z.count == 0) {
+		return result;
+	}
+	
+	uint64_t sorted[PROFILER_WINDOW];
+	std::copy(z.window, z.window + z.count, sorted);
+	std::sort(sorted, sorted + z.count);
+	
+	auto percentile = [&](double p) {
+		int i = (int)(p * (z.count - 1) + 0.5);
+		return (double)sorted[i] / (double)SDL_NS_PER_MS;
+	};
+	
+	result.p50_ms = percentile(0.50);
+	result.p95_ms = percentile(0.95);
+	result.p99_ms = percentile(0.99);
+	
+	return result;
+	
+}
+
+
+void SDL_Profiler::draw_overlay(SDL_Renderer *renderer, float x, float y) const {
+	
+	char line[128];
+	float line_h = SDL_DEBUG_TEXT_FONT_CHARACTER_SIZE + 2;
+	
+	SDL_RenderDebugText(renderer, x, y, "zone              p50     p95     p99 (ms)");
+	
+	int count = zone_count.load();
+	for (int i = 0; i < count; i++) {
+		SDL_ZoneStats s = stats(i);
+		SDL_snprintf(line, sizeof(line), "%-16.16s %6.2f  %6.2f  %6.2f", s.name, s.p50_ms, s.p95_ms, s.p99_ms);
+		SDL_RenderDebugText(renderer, x, y + line_h * (i + 1), line);
+	}
+	
+}
+
+
+bool SDL_Profiler::write_chrome_trace(const char *path) const {
+	
+	FILE *file = fopen(path, "w");
+	if (!file) {
+		fprintf(stderr, "Error opening trace file \"%s\".\n", path);
+		return false;
+	}
+	
+	// chrome://tracing / perfetto "complete" events, times in microseconds
+	fprintf(file, "{\"traceEvents\":[\n");
+	
+	uint64_t end = write_index.load(std::memory_order_acquire);
+	uint64_t start = end > PROFILER_RING_SIZE ? end - PROFILER_RING_SIZE : 0;
+	bool first = true;
+	
+	for (uint64_t i = start; i < end; i++) {
+		
+		Sample sample;
+		if (!read(i, sample)) {
+			continue;
+		}
+		
+		fprintf(file, "%s{\"name\":", first ? "" : ",\n");
+		write_json_string(file, zones[sample.zone].name);
+		fprintf(file, ",\"ph\":\"X\",\"pid\":0,\"tid\":%llu,\"ts\":%.3f,\"dur\":%.3f}",
+		        (unsigned long long)sample.thread,
+		        sample.start_ns / 1000.0,
+		        (sample.end_ns - sample.start_ns) / 1000.0);
+		first = false;
+	}
+	
+	fprintf(file, "\n]}\n");
+	fclose(file);
+	
+	return true;
+	
+}
+
+
+bool SDL_Profiler::write_csv(const char *path) const {
+	
+	FILE *file = fopen(path, "w");
+	if (!file) {
+		fprintf(stderr, "Error opening csv file \"%s\".\n", path);
+		return false;
+	}
+	
+	fprintf(file, "zone,thread,start_ns,duration_ns\n");
+	
+	uint64_t end = write_index.load(std::memory_order_acquire);
+	uint64_t start = end > PROFILER_RING_SIZE ? end - PROFILER_RING_SIZE : 0;
+	
+	for (uint64_t i = start; i < end; i++) {
+		
+		Sample sample;
+		if (!read(i, sample)) {
+			continue;
+		}
+		
+		write_csv_field(file, zones[sample.zone].name);
+		fprintf(file, ",%llu,%llu,%llu\n",
+		        (unsigned long long)sample.thread,
+		        (unsigned long long)sample.start_ns,
+		        (unsigned long long)(sample.end_ns - sample.start_ns));
+	}
+	
+	fclose(file);
+	
+	return true;
+	
+}
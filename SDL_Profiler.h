@@ -0,0 +1,113 @@
+#ifndef SDL_PROFILER_H
+#define SDL_PROFILER_H
+
+#include <SDL3/SDL.h>
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+#include <stdint.h>
+
+#define PROFILER_RING_SIZE 65536  // zone events kept for export, power of two
+#define PROFILER_WINDOW 256       // samples per zone for rolling percentiles
+#define PROFILER_MAX_ZONES 256
+
+struct SDL_ZoneStats {
+	const char *name;
+	uint64_t count;  // samples in window
+	double p50_ms;
+	double p95_ms;
+	double p99_ms;
+};
+
+// Process-wide zone profiler. Zones record into a lock-free ring buffer from
+// any thread; end_frame() (main thread) folds new events into per-zone rolling
+// windows. Use through the SDL_PROFILE_* macros, which compile to nothing
+// unless SDL_APP_PROFILE is defined.
+class SDL_Profiler {
+	
+	// payload is relaxed atomics so a reader racing a writer on a lapped slot is
+	// well defined - the sequence recheck then throws the torn copy away
+	struct Event {
+		std::atomic<uint64_t> sequence; // ring index + 1 once written, 0 while empty
+		std::atomic<uint16_t> zone;
+		std::atomic<uint64_t> thread;
+		std::atomic<uint64_t> start_ns;
+		std::atomic<uint64_t> end_ns;
+	};
+	
+	// consistent copy of one event
+	struct Sample {
+		uint16_t zone;
+		uint64_t thread;
+		uint64_t start_ns;
+		uint64_t end_ns;
+	};
+	
+	struct Zone {
+		const char *name;
+		uint64_t window[PROFILER_WINDOW]; // durations in ns
+		int next;
+		int count;
+	};
+	
+	Event ring[PROFILER_RING_SIZE];
+	std::atomic<uint64_t> write_index;
+	uint64_t read_index; // main thread - next event not yet folded into zone windows
+	
+	Zone zones[PROFILER_MAX_ZONES];
+	std::atomic<int> zone_count;
+	std::mutex zones_mutex;
+	
+	SDL_Profiler();
+	
+	public:
+		static SDL_Profiler &instance();
+		
+		uint16_t zone_id(const char *name);
+		
+		void record(uint16_t zone, uint64_t start_ns, uint64_t end_ns);
+		void end_frame();
+		
+		int get_zone_count() const { return zone_count.load(); }
+		SDL_ZoneStats stats(int zone) const;
+		
+		void draw_overlay(SDL_Renderer *renderer, float x, float y) const;
+		bool write_chrome_trace(const char *path) const;
+		bool write_csv(const char *path) const;
+	
+	private:
+		bool read(uint64_t index, Sample &sample) const;
+	
+};
+
+
+// Records the enclosing scope as one event of a zone
+class SDL_ProfileScope {
+	
+	uint16_t zone;
+	uint64_t start;
+	
+	public:
+		SDL_ProfileScope(uint16_t z) : zone(z), start(SDL_GetTicksNS()) {}
+		~SDL_ProfileScope() { SDL_Profiler::instance().record(zone, start, SDL_GetTicksNS()); }
+	
+};
+
+
+#define SDL_PROFILE_CONCAT_INNER(a, b) a##b
+#define SDL_PROFILE_CONCAT(a, b) SDL_PROFILE_CONCAT_INNER(a, b)
+
+#ifdef SDL_APP_PROFILE
+// name must be a string literal - zone is registered once per call site
+#define SDL_PROFILE_ZONE(name) \
+	static const uint16_t SDL_PROFILE_CONCAT(sdl_profile_id_, __LINE__) = SDL_Profiler::instance().zone_id(name); \
+	SDL_ProfileScope SDL_PROFILE_CONCAT(sdl_profile_scope_, __LINE__)(SDL_PROFILE_CONCAT(sdl_profile_id_, __LINE__))
+#define SDL_PROFILE_FRAME() SDL_Profiler::instance().end_frame()
+#else
+#define SDL_PROFILE_ZONE(name) ((void)0)
+#define SDL_PROFILE_FRAME() ((void)0)
+#endif
+
+#endif
@@ -0,0 +1,225 @@
+#include "SDL_Runtime.h"
+
+#include <stdio.h>
+
+
+SDL_Runtime::SDL_Runtime() {
+	
+	video_users = 0;
+	text_users = 0;
+	audio_users = 0;
+	
+	audio_started = false;
+	device = NULL;
+	audio_failed = false;
+	device_failed = false;
+	
+	counters = {0, 0, 0, 0, 0};
+	
+}
+
+
+SDL_Runtime &SDL_Runtime::instance() {
+	static SDL_Runtime runtime; // built on first use
+	return runtime;
+}
+
+
+bool SDL_Runtime::acquire_video() {
+	
+	std::lock_guard<std::mutex> guard(lock);
+	
+	if (video_users == 0) {
+		
+		uint64_t start = SDL_GetTicksNS();
+		
+		if (!SDL_InitSubSystem(SDL_INIT_VIDEO)) { // also brings up events
+			fprintf(stderr, "Error initiating SDL video: %s\n", SDL_GetError());
+			return false;
+		}
+		
+		counters.video_init_ns = SDL_GetTicksNS() - start;
+	}
+	
+	video_users++;
+	return true;
+	
+}
+
+
+void SDL_Runtime::release_video() {
+	
+	std::lock_guard<std::mutex> guard(lock);
+	
+	if (video_users == 0) {
+		return;
+	}
+	
+	if (--video_users == 0) {
+		SDL_QuitSubSystem(SDL_INIT_VIDEO);
+	}
+	
+	quit_if_unused();
+	
+}
+
+
+bool SDL_Runtime::acquire_text() {
+	
+	std::lock_guard<std::mutex> guard(lock);
+	
+	if (text_users == 0) {
+		
+		uint64_t start = SDL_GetTicksNS();
+		
+		if (!TTF_Init()) {
+			fprintf(stderr, "Error initiating TTF: %s\n", SDL_GetError());
+			return false;
+		}
+		
+		counters.text_init_ns = SDL_GetTicksNS() - start;
+	}
+	
+	text_users++;
+	return true;
+	
+}
+
+
+void SDL_Runtime::release_text() {
+	
+	std::lock_guard<std::mutex> guard(lock);
+	
+	if (text_users == 0) {
+		return;
+	}
+	
+	if (--text_users == 0) {
+		TTF_Quit();
+	}
+	
+	quit_if_unused();
+	
+}
+
+
+void SDL_Runtime::acquire_audio() {
+	std::lock_guard<std::mutex> guard(lock);
+	audio_users++; // nothing starts until audio() or mixer() is called
+}
+
+
+void SDL_Runtime::release_audio() {
+	
+	std::lock_guard<std::mutex> guard(lock);
+	
+	if (audio_users == 0) {
+		return;
+	}
+	
+	if (--audio_users == 0) {
+		
+		if (device) { // users destroyed their tracks already - mixer frees anything left
+			MIX_DestroyMixer(device);
+			device = NULL;
+		}
+		
+		if (audio_started) {
+			MIX_Quit();
+			SDL_QuitSubSystem(SDL_INIT_AUDIO);
+			audio_started = false;
+		}
+		
+		audio_failed = false; // next user may try again
+		device_failed = false;
+	}
+	
+	quit_if_unused();
+	
+}
+
+
+bool SDL_Runtime::audio() {
+	std::lock_guard<std::mutex> guard(lock);
+	return start_audio();
+}
+
+
+MIX_Mixer *SDL_Runtime::mixer() {
+	
+	std::lock_guard<std::mutex> guard(lock);
+	
+	if (device || device_failed || !start_audio()) {
+		return device;
+	}
+	
+	uint64_t start = SDL_GetTicksNS();
+	
+	SDL_AudioSpec audiospec;
+	audiospec.format = MIX_DEFAULT_FORMAT;
+	audiospec.channels = MIX_DEFAULT_CHANNELS; // stereo or mono
+	audiospec.freq = MIX_DEFAULT_FREQUENCY;
+	
+	device = MIX_CreateMixerDevice(SDL_AUDIO_DEVICE_DEFAULT_PLAYBACK, &audiospec);
+	
+	if (!device) {
+		fprintf(stderr, "Error opening audio device: %s\n", SDL_GetError());
+		device_failed = true;
+		return NULL;
+	}
+	
+	counters.device_open_ns = SDL_GetTicksNS() - start;
+	counters.audio_devices++;
+	
+	return device;
+	
+}
+
+
+bool SDL_Runtime::start_audio() {
+	
+	// lock held by caller
+	if (audio_started) {
+		return true;
+	}
+	
+	if (audio_failed) {
+		return false;
+	}
+	
+	if (audio_users == 0) {
+		fprintf(stderr, "Error - audio requested without acquire_audio().\n");
+		return false;
+	}
+	
+	uint64_t start = SDL_GetTicksNS();
+	
+	if (!SDL_InitSubSystem(SDL_INIT_AUDIO)) {
+		fprintf(stderr, "Error initiating SDL audio: %s\n", SDL_GetError());
+		audio_failed = true;
+		return false;
+	}
+	
+	if (!MIX_Init()) {
+		fprintf(stderr, "Error initiating MIX: %s\n", SDL_GetError());
+		SDL_QuitSubSystem(SDL_INIT_AUDIO);
+		audio_failed = true;
+		return false;
+	}
+	
+	counters.audio_init_ns = SDL_GetTicksNS() - start;
+	audio_started = true;
+	
+	return true;
+	
+}
+
+
+void SDL_Runtime::quit_if_unused() {
+	
+	// lock held by caller
+	if (video_users == 0 && text_users == 0 && audio_users == 0) {
+		SDL_Quit(); // whatever was started outside the runtime (hints, events) goes too
+	}
+	
+}
@@ -0,0 +1,79 @@
+#ifndef SDL_RUNTIME_H
+#define SDL_RUNTIME_H
+
+#include <SDL3/SDL.h>
+#include <SDL3_ttf/SDL_ttf.h>
+#include <SDL3_mixer/SDL_mixer.h>
+
+#include <mutex>
+
+// audio mixer defaults - used for the shared playback device
+#ifndef MIX_DEFAULT_FREQUENCY
+#define MIX_DEFAULT_FREQUENCY 44100
+#endif
+#ifndef MIX_DEFAULT_FORMAT
+#define MIX_DEFAULT_FORMAT SDL_AUDIO_S16
+#endif
+#ifndef MIX_DEFAULT_CHANNELS
+#define MIX_DEFAULT_CHANNELS 2
+#endif
+
+// time spent bringing each part online, 0 until it has started
+struct SDL_RuntimeStats {
+	uint64_t video_init_ns;
+	uint64_t text_init_ns;
+	uint64_t audio_init_ns; // audio subsystem + mixer module (decoders)
+	uint64_t device_open_ns;
+	int audio_devices;      // playback devices opened so far
+};
+
+// Process-wide owner of SDL, SDL_ttf and SDL_mixer. Every user (application,
+// soundboard, text cache) acquires the parts it needs and releases them when
+// done; a part starts on first use and stops when its last user releases it.
+// SDL_Quit() runs once nothing is held any more.
+//
+// Audio is lazier still: acquire_audio() only registers a user. The audio
+// subsystem and mixer module start on the first audio() call (needed to load
+// sounds), the single shared playback device on the first mixer() call, so
+// programs that never play a sound never open one.
+class SDL_Runtime {
+	
+	std::mutex lock;
+	
+	int video_users;
+	int text_users;
+	int audio_users;
+	
+	bool audio_started;
+	MIX_Mixer *device; // shared playback mixer, NULL until first mixer()
+	bool audio_failed;  // don't retry missing audio every call
+	bool device_failed; // nor a playback device that wouldn't open - decoding still works
+	
+	SDL_RuntimeStats counters;
+	
+	SDL_Runtime();
+	
+	public:
+		static SDL_Runtime &instance();
+		
+		bool acquire_video();
+		void release_video();
+		
+		bool acquire_text();
+		void release_text();
+		
+		void acquire_audio();
+		void release_audio();
+		bool audio();       // starts audio and the mixer module - enough to load sounds
+		MIX_Mixer *mixer(); // also opens the shared device on first call - NULL if audio is unavailable
+		
+		bool audio_open() const { return device != NULL; }
+		const SDL_RuntimeStats &stats() const { return counters; }
+		
+	private:
+		bool start_audio();
+		void quit_if_unused();
+	
+};
+
+#endif
@@ -1,78 +1,205 @@
 #include "SDL_Soundboard.h"
 
 
-SDL_Soundboard::SDL_Soundboard() {
+SDL_Soundboard::SDL_Soundboard(MIX_Mixer *m) {
 	
-	if (!SDL_Init(SDL_FLAGS)) { // initialize SDL for audio only
-		fprintf(stderr, "Error initializing SDL3: %s\n", SDL_GetError());
+	// shares the process-wide audio runtime - an application in the same process plays on the same device
+	SDL_Runtime::instance().acquire_audio();
+	
+	mixer = m;
+	music_track = NULL;
+	
+	budget_bytes = 0;
+	resident = 0;
+	use_clock = 0;
+	evictions = 0;
+	reloads = 0;
+	
+}
+
+
+SDL_Soundboard::~SDL_Soundboard() {
+	
+	free_audios();
+	free_tracks();
+	mixer = NULL; // shared or caller's - never destroyed here
+	
+	SDL_Runtime::instance().release_audio(); // SDL stays up while anything else holds it
+	
+}
+
+
+void SDL_Soundboard::assign_audios(const std::map<std::string, MIX_Audio*> &as) {
+	for (const auto &entry : as) {
+		push_audio(entry.first, entry.second);
 	}
+}
+
+	
+SDL_SoundID SDL_Soundboard::push_audio(const std::string &id, const std::string &path) {
 	
-	if (!MIX_Init()) { // initialize MIX component
-		fprintf(stderr, "Error initializing SDL3_mixer: %s\n", SDL_GetError());
+	SDL_Runtime::instance().audio(); // decoders only - no device needed to load
+	MIX_Audio *audio = MIX_LoadAudio(mixer, path.c_str(), true);
+	
+	if (!audio) {
+		fprintf(stderr, "Error loading audio \"%s\": %s\n", path.c_str(), SDL_GetError());
+		return SDL_SOUND_INVALID;
 	}
 	
-	// create audiospec struct for mixer generation
-	SDL_AudioSpec audiospec;
-	audiospec.format = MIX_DEFAULT_FORMAT;
-	audiospec.channels = MIX_DEFAULT_CHANNELS; // stereo or mono
-	audiospec.freq = MIX_DEFAULT_FREQUENCY;
+	return add_slot(id, audio, path, false);
 	
-	// populate mixer
-	mixer = MIX_CreateMixerDevice(SDL_AUDIO_DEVICE_DEFAULT_PLAYBACK, &audiospec);
+}
+
+
+SDL_SoundID SDL_Soundboard::push_audio(const std::string &id, MIX_Audio *audio) {
+	return add_slot(id, audio, std::string(), false); // no path - can't be reloaded, so never evicted
+}
+
+
+SDL_SoundID SDL_Soundboard::push_music(const std::string &id, const std::string &path) {
 	
-	sfx_track = MIX_CreateTrack(mixer);
-	music_track = MIX_CreateTrack(mixer);
+	// predecode=false - decoded in small chunks while playing instead of held as pcm
+	SDL_Runtime::instance().audio();
+	MIX_Audio *audio = MIX_LoadAudio(mixer, path.c_str(), false);
+	
+	if (!audio) {
+		fprintf(stderr, "Error loading music \"%s\": %s\n", path.c_str(), SDL_GetError());
+		return SDL_SOUND_INVALID;
+	}
+	
+	return add_slot(id, audio, path, true);
 	
 }
 
 
-SDL_Soundboard::~SDL_Soundboard() {
+SDL_SoundID SDL_Soundboard::add_slot(const std::string &id, MIX_Audio *audio, const std::string &path, bool streamed) {
 	
-	free_audios();
-	free_tracks();
+	free_audio(id); // re-pushing a name replaces the old sound
+	
+	uint16_t index;
+	
+	if (!free_slots.empty()) {
+		index = free_slots.back();
+		free_slots.pop_back();
+	}
+	else {
+		if (slots.size() >= 0xFFFF) {
+			fprintf(stderr, "Error - soundboard is full, \"%s\" not added.\n", id.c_str());
+			MIX_DestroyAudio(audio);
+			return SDL_SOUND_INVALID;
+		}
+		index = (uint16_t)slots.size();
+		slots.push_back({NULL, 1, false, false, std::string(), std::string(), 0, 0});
+	}
 	
-	MIX_DestroyMixer(mixer);
-	mixer = NULL;
+	Slot &slot = slots[index];
+	slot.audio = audio;
+	slot.used = true;
+	slot.streamed = streamed;
+	slot.name = id;
+	slot.path = path;
+	slot.bytes = streamed ? 0 : decoded_size(audio);
+	slot.last_used = ++use_clock;
 	
-	MIX_Quit();                  
-	SDL_Quit(); 
+	resident += slot.bytes;
+	enforce_budget(&slot);
+	
+	SDL_SoundID sound = ((SDL_SoundID)slot.generation << 16) | index;
+	names[id] = sound;
+	
+	return sound;
 	
 }
 
 
-void SDL_Soundboard::assign_audios(std::map<std::string, MIX_Audio*> as) {
-	audios = as;
+SDL_SoundID SDL_Soundboard::find(const std::string &id) const {
+	
+	auto found = names.find(id);
+	if (found == names.end()) {
+		return SDL_SOUND_INVALID;
+	}
+	
+	return found->second;
 }
 
+
+MIX_Audio *SDL_Soundboard::audio(SDL_SoundID sound) const {
 	
-void SDL_Soundboard::push_audio(std::string id, std::string path) {
+	uint32_t index = sound & 0xFFFF;
+	uint16_t generation = (uint16_t)(sound >> 16);
 	
-	MIX_Audio *audio = MIX_LoadAudio(mixer, path.c_str(), true);
+	if (index >= slots.size() || !slots[index].used || slots[index].generation != generation) {
+		return NULL;
+	}
+	
+	return slots[index].audio;
+}
+
+
+SDL_Soundboard::Slot *SDL_Soundboard::slot(SDL_SoundID sound) {
+	
+	uint32_t index = sound & 0xFFFF;
+	uint16_t generation = (uint16_t)(sound >> 16);
 	
-	audios[id] = audio;
+	if (index >= slots.size() || !slots[index].used || slots[index].generation != generation) {
+		return NULL;
+	}
 	
+	return &slots[index];
 }
 
 
-void SDL_Soundboard::free_audio(std::string id) {
+void SDL_Soundboard::free_audio(SDL_SoundID sound) {
 	
-	if (audios.find(id) == audios.end()) {
+	Slot *s = slot(sound);
+	if (!s) {
 		return;
 	}
 	
-	MIX_DestroyAudio(audios[id]);
-	audios.erase(id);
+	Slot &slot = *s;
+	
+	if (slot.audio) { // evicted sounds have nothing to destroy
+		MIX_DestroyAudio(slot.audio);
+		resident -= slot.bytes;
+	}
+	names.erase(slot.name);
+	
+	slot.audio = NULL;
+	slot.used = false;
+	slot.name.clear();
+	slot.path.clear();
+	slot.bytes = 0;
+	
+	// invalidate outstanding handles, skip 0 so no handle equals SDL_SOUND_INVALID
+	slot.generation++;
+	if (slot.generation == 0) {
+		slot.generation = 1;
+	}
+	
+	free_slots.push_back((uint16_t)(sound & 0xFFFF));
+	
+}
+
+
+void SDL_Soundboard::free_audio(const std::string &id) {
+	free_audio(find(id));
 }
 
 	
-void SDL_Soundboard::play_music(std::string id) {
+void SDL_Soundboard::play_music(SDL_SoundID sound) {
+	
+	Slot *s = slot(sound);
+	MIX_Audio *a = s ? resident_audio(s) : NULL;
+	if (!a) {
+		fprintf(stderr, "Error - sound %u does not match any loaded track.\n", (unsigned)sound);
+		return;
+	}
 	
-	if (audios.find(id) == audios.end()) {
-		fprintf(stderr, "Error - id \"%s\" does not match any loaded track.\n", id);
+	if (!open_tracks()) {
 		return;
 	}
 	
-	if (!MIX_SetTrackAudio(music_track, audios[id])) {
+	if (!MIX_SetTrackAudio(music_track, a)) {
 		fprintf(stderr, "Error setting music track: %s\n", SDL_GetError());
 	}
 	if (!MIX_PlayTrack(music_track, 0)) {
@@ -81,34 +208,159 @@ void SDL_Soundboard::play_music(std::string id) {
 }
 
 
-void SDL_Soundboard::play_sfx(std::string id) {
+void SDL_Soundboard::play_sfx(SDL_SoundID sound, int priority, float gain) {
 	
-	if (audios.find(id) == audios.end()) {
-		fprintf(stderr, "Error - id \"%s\" does not match any loaded track.\n", id);
+	Slot *s = slot(sound);
+	MIX_Audio *a = s ? resident_audio(s) : NULL;
+	if (!a) {
+		fprintf(stderr, "Error - sound %u does not match any loaded track.\n", (unsigned)sound);
 		return;
 	}
 	
-	if (!MIX_SetTrackAudio(sfx_track, audios[id])) {
-		fprintf(stderr, "Error setting sfx track: %s\n", SDL_GetError());
+	s->last_used = ++use_clock;
+	
+	if (!open_tracks()) {
+		return;
+	}
+	
+	sfx_voices.play(a, priority, gain); // takes a free voice or steals one
+}
+
+
+void SDL_Soundboard::set_sfx_budget(size_t bytes) {
+	budget_bytes = bytes;
+	enforce_budget(NULL);
+}
+
+
+bool SDL_Soundboard::open_tracks() {
+	
+	if (music_track) {
+		return true;
+	}
+	
+	if (!mixer) {
+		mixer = SDL_Runtime::instance().mixer(); // first sound played - device opens now
+		if (!mixer) {
+			return false;
+		}
 	}
-	if (!MIX_PlayTrack(sfx_track, 0)) {
-		fprintf(stderr, "Error playing sfx: %s\n", SDL_GetError());
+	
+	sfx_voices.create(mixer);
+	music_track = MIX_CreateTrack(mixer);
+	
+	if (!music_track) {
+		fprintf(stderr, "Error creating music track: %s\n", SDL_GetError());
+		return false;
 	}
+	
+	return true;
+	
+}
+
+
+MIX_Audio *SDL_Soundboard::resident_audio(Slot *s) {
+	
+	if (s->audio || s->path.empty()) {
+		return s->audio;
+	}
+	
+	// evicted - decode again from source
+	s->audio = MIX_LoadAudio(mixer, s->path.c_str(), true);
+	if (!s->audio) {
+		fprintf(stderr, "Error reloading audio \"%s\": %s\n", s->path.c_str(), SDL_GetError());
+		return NULL;
+	}
+	
+	s->bytes = decoded_size(s->audio);
+	resident += s->bytes;
+	reloads++;
+	
+	enforce_budget(s);
+	
+	return s->audio;
+	
+}
+
+
+void SDL_Soundboard::enforce_budget(const Slot *keep) {
+	
+	while (budget_bytes > 0 && resident > budget_bytes) {
+		
+		// least recently played sound that can be reloaded
+		Slot *victim = NULL;
+		for (Slot &s : slots) {
+			if (&s == keep || !s.used || !s.audio || s.streamed || s.path.empty()) {
+				continue;
+			}
+			if (!victim || s.last_used < victim->last_used) {
+				victim = &s;
+			}
+		}
+		
+		if (!victim) { // everything left is pinned
+			break;
+		}
+		
+		// tracks still playing this audio hold their own reference - mixer frees it when they finish
+		MIX_DestroyAudio(victim->audio);
+		victim->audio = NULL;
+		resident -= victim->bytes;
+		victim->bytes = 0;
+		evictions++;
+	}
+	
+}
+
+
+size_t SDL_Soundboard::decoded_size(MIX_Audio *audio) {
+	
+	SDL_AudioSpec spec;
+	if (!MIX_GetAudioFormat(audio, &spec)) {
+		return 0;
+	}
+	
+	Sint64 frames = MIX_GetAudioDuration(audio); // in sample frames
+	if (frames <= 0) {
+		return 0;
+	}
+	
+	return (size_t)frames * spec.channels * SDL_AUDIO_BYTESIZE(spec.format);
+}
+
+
+void SDL_Soundboard::set_steal_policy(SDL_StealPolicy policy) {
+	sfx_voices.policy = policy;
+}
+
+
+void SDL_Soundboard::begin_frame() {
+	sfx_voices.begin_frame();
 }
 
 
 void SDL_Soundboard::free_audios() {
-	for (auto audio : audios) {
-		free_audio(audio.first);
+	
+	for (Slot &slot : slots) {
+		if (slot.used && slot.audio) {
+			MIX_DestroyAudio(slot.audio);
+		}
 	}
+	
+	resident = 0;
+	slots.clear();
+	free_slots.clear();
+	names.clear();
+	
 }
 
 
 void SDL_Soundboard::free_tracks() {
 	
-	MIX_DestroyTrack(music_track);
-	music_track = NULL;
+	if (music_track) { // never created if nothing was played
+		MIX_DestroyTrack(music_track);
+		music_track = NULL;
+	}
 	
-	MIX_DestroyTrack(sfx_track);
-	sfx_track = NULL;
+	sfx_voices.destroy();
 }
@@ -3,38 +3,86 @@
 
 #include <iostream>
 #include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
 #include <SDL3/SDL.h>
 #include <SDL3/SDL_main.h>
 #include <SDL3_mixer/SDL_mixer.h>
 
-#define SDL_FLAGS SDL_INIT_AUDIO
+#include "SDL_Runtime.h"
+#include "SDL_VoicePool.h"
 
-#define MIX_DEFAULT_FREQUENCY 44100
-#define MIX_DEFAULT_FORMAT SDL_AUDIO_S16
-#define MIX_DEFAULT_CHANNELS 2
+// Handle to a loaded sound - slot index in low 16 bits, slot generation in
+// high 16 bits. Stale handles (sound freed, slot reused) resolve to nothing.
+typedef uint32_t SDL_SoundID;
+#define SDL_SOUND_INVALID ((SDL_SoundID)0)
 
 
 class SDL_Soundboard {
 	
-	MIX_Mixer *mixer;
-	MIX_Track *music_track;
-	MIX_Track *sfx_track;
+	struct Slot {
+		MIX_Audio *audio;    // NULL while evicted
+		uint16_t generation; // bumped on free, never 0
+		bool used;
+		bool streamed;       // decoded while playing - not resident, never evicted
+		std::string name;
+		std::string path;    // source for reload after eviction, empty if pushed as MIX_Audio
+		size_t bytes;        // decoded pcm size while resident
+		uint64_t last_used;  // use_clock at last play
+	};
 	
-	std::map<std::string, MIX_Audio*> audios;
+	MIX_Mixer *mixer;        // not owned - runtime's shared device unless one was passed in
+	MIX_Track *music_track;  // tracks are created on first play
+	SDL_VoicePool sfx_voices; // overlapping sfx, see SFX_DEFAULT_VOICES
+	
+	std::vector<Slot> slots;
+	std::vector<uint16_t> free_slots;
+	std::unordered_map<std::string, SDL_SoundID> names; // setup lookups only - play paths take handles
+	
+	// decoded sfx memory budget
+	size_t budget_bytes;   // 0 = unlimited
+	size_t resident;
+	uint64_t use_clock;
+	uint64_t evictions;
+	uint64_t reloads;
 	
 	public:
-		SDL_Soundboard();
+		SDL_Soundboard(MIX_Mixer *m = NULL); // NULL = shared device, opened on first play
 		~SDL_Soundboard();
 		
-		void assign_audios(std::map<std::string, MIX_Audio*> as);
+		void assign_audios(const std::map<std::string, MIX_Audio*> &as);
+		
+		SDL_SoundID push_audio(const std::string &id, const std::string &path);
+		SDL_SoundID push_audio(const std::string &id, MIX_Audio *audio); // takes ownership
+		SDL_SoundID push_music(const std::string &id, const std::string &path); // streamed, not predecoded
+		SDL_SoundID find(const std::string &id) const;
+		MIX_Audio *audio(SDL_SoundID sound) const; // NULL if unknown or evicted
 		
-		void push_audio(std::string id, std::string path);
-		void free_audio(std::string id);
+		void free_audio(SDL_SoundID sound);
+		void free_audio(const std::string &id);
 		
-		void play_music(std::string id);
-		void play_sfx(std::string id);
+		void play_music(SDL_SoundID sound);
+		void play_sfx(SDL_SoundID sound, int priority = 0, float gain = 1.0f);
+		
+		void set_steal_policy(SDL_StealPolicy policy);
+		void begin_frame(); // call once per frame to roll sfx stats over
+		const SDL_VoiceStats &sfx_stats() const { return sfx_voices.frame_stats(); }
+		
+		// predecoded sfx over budget are evicted least recently played first and reloaded on next play
+		void set_sfx_budget(size_t bytes);
+		size_t resident_bytes() const { return resident; }
+		uint64_t eviction_count() const { return evictions; }
+		uint64_t reload_count() const { return reloads; }
 		
 	private:
+		bool open_tracks();
+		Slot *slot(SDL_SoundID sound);
+		SDL_SoundID add_slot(const std::string &id, MIX_Audio *audio, const std::string &path, bool streamed);
+		MIX_Audio *resident_audio(Slot *s);
+		void enforce_budget(const Slot *keep);
+		static size_t decoded_size(MIX_Audio *audio);
+		
 		void free_tracks();
 		void free_audios();
 	
@@ -0,0 +1,420 @@
+#include "SDL_SpatialHash.h"
+
+#include <algorithm>
+
+#include <math.h>
+
+
+SDL_SpatialHash::SDL_SpatialHash(float cell) {
+	
+	cell_size = cell > 0.0f ? cell : 64.0f;
+	inv_cell = 1.0f / cell_size;
+	
+	count = 0;
+	query_stamp = 0;
+	
+	min_x = min_y = 0;
+	max_x = max_y = -1; // empty
+	
+}
+
+
+void SDL_SpatialHash::set_cell_size(float cell) {
+	
+	if (cell <= 0.0f) {
+		return;
+	}
+	
+	cell_size = cell;
+	inv_cell = 1.0f / cell;
+	
+	// re-link everything under new cell size
+	cells.clear();
+	min_x = min_y = 0;
+	max_x = max_y = -1;
+	
+	for (int id = 0; id < (int)objects.size(); id++) {
+		if (objects[id].used) {
+			Object &o = objects[id];
+			cell_range(o.rect, &o.x0, &o.y0, &o.x1, &o.y1);
+			link(id);
+		}
+	}
+	
+}
+
+
+void SDL_SpatialHash::insert(int id, const SDL_FRect &rect) {
+	
+	if (id < 0) {
+		return;
+	}
+	
+	if (id >= (int)objects.size()) {
+		objects.resize(id + 1, {{0.0f, 0.0f, 0.0f, 0.0f}, 0, 0, -1, -1, false, 0});
+	}
+	
+	if (objects[id].used) { // already in - treat as move
+		update(id, rect);
+		return;
+	}
+	
+	Object &o = objects[id];
+	o.rect = rect;
+	o.used = true;
+	o.stamp = 0;
+	cell_range(rect, &o.x0, &o.y0, &o.x1, &o.y1);
+	
+	link(id);
+	count++;
+	
+}
+
+
+void SDL_SpatialHash::update(int id, const SDL_FRect &rect) {
+	
+	if (!contains(id)) {
+		insert(id, rect);
+		return;
+	}
+	
+	Object &o = objects[id];
+	o.rect = rect;
+	
+	int x0, y0, x1, y1;
+	cell_range(rect, &x0, &y0, &x1, &y1);
+	
+	if (x0 == o.x0 && y0 == o.y0 && x1 == o.x1 && y1 == o.y1) { // same cells - nothing to relink
+		return;
+	}
+	
+	unlink(id);
+	o.x0 = x0;
+	o.y0 = y0;
+	o.x1 = x1;
+	o.y1 = y1;
+	link(id);
+	
+}
+
+
+void SDL_SpatialHash::remove(int id) {
+	
+	if (!contains(id)) {
+		return;
+	}
+	
+	unlink(id);
+	objects[id].used = false;
+	count--;
+	
+}
+
+
+void SDL_SpatialHash::clear() {
+	
+	objects.clear();
+	cells.clear();
+	count = 0;
+	
+	min_x = min_y = 0;
+	max_x = max_y = -1;
+	
+}
+
+
+void SDL_SpatialHash::query_rect(const SDL_FRect &rect, std::vector<int> &out) {
+	
+	out.clear();
+	
+	int x0, y0, x1, y1;
+	cell_range(rect, &x0, &y0, &x1, &y1);
+	
+	// clamp to populated area - a huge view rect over a small world stays cheap
+	x0 = std::max(x0, min_x);
+	y0 = std::max(y0, min_y);
+	x1 = std::min(x1, max_x);
+	y1 = std::min(y1, max_y);
+	
+	uint32_t stamp = next_stamp();
+	
+	for (int cy = y0; cy <= y1; cy++) {
+		for (int cx = x0; cx <= x1; cx++) {
+			
+			auto cell = cells.find(key(cx, cy));
+			if (cell == cells.end()) {
+				continue;
+			}
+			
+			for (int id : cell->second) {
+				Object &o = objects[id];
+				if (o.stamp != stamp) {
+					o.stamp = stamp;
+					if (overlaps(o.rect, rect)) {
+						out.push_back(id);
+					}
+				}
+			}
+		}
+	}
+	
+}
+
+
+void SDL_SpatialHash::query_radius(SDL_FPoint center, float radius, std::vector<int> &out) {
+	
+	SDL_FRect bounds = {center.x - radius, center.y - radius, radius * 2.0f, radius * 2.0f};
+	query_rect(bounds, out);
+	
+	// narrow box hits down to the circle
+	float r2 = radius * radius;
+	out.erase(std::remove_if(out.begin(), out.end(), [&](int id) {
+		return distance_sq(center, objects[id].rect) > r2;
+	}), out.end());
+	
+}
+
+
+void SDL_SpatialHash::nearest(SDL_FPoint point, int k, std::vector<int> &out) {
+	
+	out.clear();
+	
+	if (k <= 0 || count == 0) {
+		return;
+	}
+	if (k > count) {
+		k = count;
+	}
+	
+	heap.clear();
+	next_stamp();
+	
+	int cx = (int)floorf(point.x * inv_cell);
+	int cy = (int)floorf(point.y * inv_cell);
+	
+	// rings that can hold objects - nearest one touching the populated bounds to the furthest
+	int gap_x = std::max(std::max(min_x - cx, cx - max_x), 0);
+	int gap_y = std::max(std::max(min_y - cy, cy - max_y), 0);
+	int first = std::max(gap_x, gap_y);
+	int reach = std::max(std::max(abs(cx - min_x), abs(cx - max_x)), std::max(abs(cy - min_y), abs(cy - max_y)));
+	
+	// search outward ring by ring, each clipped to the populated bounds so a point far
+	// outside them costs no more than one inside; every cell in ring r + 1 is at least r cells away from point
+	for (int r = first; r <= reach; r++) {
+		
+		if (r == 0) {
+			visit_cell(cx, cy, point, k);
+		}
+		else {
+			int x0 = std::max(cx - r, min_x);
+			int x1 = std::min(cx + r, max_x);
+			int y0 = std::max(cy - r + 1, min_y);
+			int y1 = std::min(cy + r - 1, max_y);
+			
+			for (int x = x0; x <= x1; x++) {
+				if (cy - r >= min_y) visit_cell(x, cy - r, point, k);
+				if (cy + r <= max_y) visit_cell(x, cy + r, point, k);
+			}
+			for (int y = y0; y <= y1; y++) {
+				if (cx - r >= min_x) visit_cell(cx - r, y, point, k);
+				if (cx + r <= max_x) visit_cell(cx + r, y, point, k);
+			}
+		}
+		
+		float bound = r * cell_size;
+		if ((int)heap.size() == k && heap.front().first <= bound * bound) {
+			break;
+		}
+	}
+	
+	std::sort_heap(heap.begin(), heap.end());
+	for (const auto &entry : heap) {
+		out.push_back(entry.second);
+	}
+	
+}
+
+
+void SDL_SpatialHash::query_rects(const SDL_FRect *rects, int n, std::vector<int> &out, std::vector<int> &offsets) {
+	
+	std::vector<int> hits;
+	
+	out.clear();
+	offsets.clear();
+	offsets.push_back(0);
+	
+	for (int i = 0; i < n; i++) {
+		query_rect(rects[i], hits);
+		out.insert(out.end(), hits.begin(), hits.end());
+		offsets.push_back((int)out.size());
+	}
+	
+}
+
+
+void SDL_SpatialHash::nearest_many(const SDL_FPoint *points, int n, int k, std::vector<int> &out, std::vector<int> &offsets) {
+	
+	std::vector<int> hits;
+	
+	out.clear();
+	offsets.clear();
+	offsets.push_back(0);
+	
+	for (int i = 0; i < n; i++) {
+		nearest(points[i], k, hits);
+		out.insert(out.end(), hits.begin(), hits.end());
+		offsets.push_back((int)out.size());
+	}
+	
+}
+
+
+void SDL_SpatialHash::query_pairs(std::vector<std::pair<int, int>> &out) {
+	
+	out.clear();
+	
+	for (const auto &cell : cells) {
+		
+		int cx = (int)(int32_t)(uint32_t)(cell.first >> 32);
+		int cy = (int)(int32_t)(uint32_t)(cell.first & 0xFFFFFFFF);
+		const std::vector<int> &ids = cell.second;
+		
+		for (size_t i = 0; i < ids.size(); i++) {
+			for (size_t j = i + 1; j < ids.size(); j++) {
+				
+				const Object &a = objects[ids[i]];
+				const Object &b = objects[ids[j]];
+				
+				if (!overlaps(a.rect, b.rect)) {
+					continue;
+				}
+				
+				// a pair shares several cells if both span them - report it only from the
+				// cell holding the top left corner of the shared cell range
+				if (cx != std::max(a.x0, b.x0) || cy != std::max(a.y0, b.y0)) {
+					continue;
+				}
+				
+				out.push_back({std::min(ids[i], ids[j]), std::max(ids[i], ids[j])});
+			}
+		}
+	}
+	
+}
+
+
+void SDL_SpatialHash::cell_range(const SDL_FRect &rect, int *x0, int *y0, int *x1, int *y1) const {
+	*x0 = (int)floorf(rect.x * inv_cell);
+	*y0 = (int)floorf(rect.y * inv_cell);
+	*x1 = (int)floorf((rect.x + rect.w) * inv_cell);
+	*y1 = (int)floorf((rect.y + rect.h) * inv_cell);
+}
+
+
+void SDL_SpatialHash::link(int id) {
+	
+	const Object &o = objects[id];
+	
+	for (int cy = o.y0; cy <= o.y1; cy++) {
+		for (int cx = o.x0; cx <= o.x1; cx++) {
+			cells[key(cx, cy)].push_back(id);
+		}
+	}
+	
+	if (max_x < min_x) { // first object
+		min_x = o.x0; min_y = o.y0;
+		max_x = o.x1; max_y = o.y1;
+	}
+	else {
+		min_x = std::min(min_x, o.x0); min_y = std::min(min_y, o.y0);
+		max_x = std::max(max_x, o.x1); max_y = std::max(max_y, o.y1);
+	}
+	
+}
+
+
+void SDL_SpatialHash::unlink(int id) {
+	
+	const Object &o = objects[id];
+	
+	for (int cy = o.y0; cy <= o.y1; cy++) {
+		for (int cx = o.x0; cx <= o.x1; cx++) {
+			
+			auto cell = cells.find(key(cx, cy));
+			if (cell == cells.end()) {
+				continue;
+			}
+			
+			// order within a cell doesn't matter - swap with last
+			std::vector<int> &ids = cell->second;
+			for (size_t i = 0; i < ids.size(); i++) {
+				if (ids[i] == id) {
+					ids[i] = ids.back();
+					ids.pop_back();
+					break;
+				}
+			}
+			// empty cells stay allocated - objects tend to come back
+		}
+	}
+	
+}
+
+
+uint32_t SDL_SpatialHash::next_stamp() {
+	
+	if (++query_stamp == 0) { // wrapped - reset so old stamps can't collide
+		for (Object &o : objects) {
+			o.stamp = 0;
+		}
+		query_stamp = 1;
+	}
+	
+	return query_stamp;
+}
+
+
+void SDL_SpatialHash::visit_cell(int cx, int cy, SDL_FPoint point, int k) {
+	
+	auto cell = cells.find(key(cx, cy));
+	if (cell == cells.end()) {
+		return;
+	}
+	
+	for (int id : cell->second) {
+		
+		Object &o = objects[id];
+		if (o.stamp == query_stamp) {
+			continue;
+		}
+		o.stamp = query_stamp;
+		
+		// max-heap of k best, worst on top
+		float d = distance_sq(point, o.rect);
+		if ((int)heap.size() < k) {
+			heap.push_back({d, id});
+			std::push_heap(heap.begin(), heap.end());
+		}
+		else if (d < heap.front().first) {
+			std::pop_heap(heap.begin(), heap.end());
+			heap.back() = {d, id};
+			std::push_heap(heap.begin(), heap.end());
+		}
+	}
+	
+}
+
+
+bool SDL_SpatialHash::overlaps(const SDL_FRect &a, const SDL_FRect &b) {
+	return a.x <= b.x + b.w && b.x <= a.x + a.w && a.y <= b.y + b.h && b.y <= a.y + a.h;
+}
+
+
+float SDL_SpatialHash::distance_sq(SDL_FPoint p, const SDL_FRect &r) {
+	
+	// distance to nearest point of box, 0 inside
+	float dx = std::max(std::max(r.x - p.x, 0.0f), p.x - (r.x + r.w));
+	float dy = std::max(std::max(r.y - p.y, 0.0f), p.y - (r.y + r.h));
+	
+	return dx * dx + dy * dy;
+}
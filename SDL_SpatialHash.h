@@ -0,0 +1,80 @@
+#ifndef SDL_SPATIALHASH_H
+#define SDL_SPATIALHASH_H
+
+#include <SDL3/SDL.h>
+
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <stdint.h>
+
+// Uniform hash grid over axis-aligned boxes. Objects are identified by a
+// caller-chosen non-negative int id (usually an index into the caller's own
+// arrays) and listed in every cell their box touches. update() only touches
+// the grid when the set of covered cells changes, so objects moving within
+// their cells cost a compare. Cell size should be around the typical object
+// size.
+class SDL_SpatialHash {
+	
+	struct Object {
+		SDL_FRect rect;
+		int x0, y0, x1, y1; // covered cell range, inclusive
+		bool used;
+		uint32_t stamp;     // last query that reported this object - dedupes multi-cell objects
+	};
+	
+	float cell_size;
+	float inv_cell;
+	
+	std::vector<Object> objects; // by id
+	std::unordered_map<uint64_t, std::vector<int>> cells;
+	int count;
+	
+	uint32_t query_stamp;
+	
+	// covered cell bounds of everything ever inserted - stops nearest() on sparse grids
+	int min_x, min_y, max_x, max_y;
+	
+	std::vector<std::pair<float, int>> heap; // nearest() scratch
+	
+	public:
+		SDL_SpatialHash(float cell = 64.0f);
+		
+		void set_cell_size(float cell); // rebuilds the grid
+		float get_cell_size() const { return cell_size; }
+		
+		void insert(int id, const SDL_FRect &rect);
+		void update(int id, const SDL_FRect &rect);
+		void remove(int id);
+		void clear();
+		
+		int size() const { return count; }
+		bool contains(int id) const { return id >= 0 && id < (int)objects.size() && objects[id].used; }
+		
+		// results replace contents of out
+		void query_rect(const SDL_FRect &rect, std::vector<int> &out);
+		void query_radius(SDL_FPoint center, float radius, std::vector<int> &out);
+		void nearest(SDL_FPoint point, int k, std::vector<int> &out); // closest first
+		
+		// batched - results of query i are out[offsets[i] .. offsets[i + 1])
+		void query_rects(const SDL_FRect *rects, int n, std::vector<int> &out, std::vector<int> &offsets);
+		void nearest_many(const SDL_FPoint *points, int n, int k, std::vector<int> &out, std::vector<int> &offsets);
+		
+		// every pair of overlapping boxes once - broad phase for collisions
+		void query_pairs(std::vector<std::pair<int, int>> &out);
+		
+	private:
+		void cell_range(const SDL_FRect &rect, int *x0, int *y0, int *x1, int *y1) const;
+		void link(int id);
+		void unlink(int id);
+		uint32_t next_stamp();
+		void visit_cell(int cx, int cy, SDL_FPoint point, int k);
+		
+		static uint64_t key(int cx, int cy) { return ((uint64_t)(uint32_t)cx << 32) | (uint32_t)cy; }
+		static bool overlaps(const SDL_FRect &a, const SDL_FRect &b);
+		static float distance_sq(SDL_FPoint p, const SDL_FRect &r);
+	
+};
+
+#endif
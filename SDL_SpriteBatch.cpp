@@ -0,0 +1,222 @@
+#include "SDL_SpriteBatch.h"
+
+#include <algorithm>
+#include <functional>
+
+#include <math.h>
+#include <stdio.h>
+
+
+SDL_SpriteBatch::SDL_SpriteBatch() {
+	
+	size_texture = NULL;
+	size_w = 0.0f;
+	size_h = 0.0f;
+	
+	last_sprites = 0;
+	last_vertices = 0;
+	last_draw_calls = 0;
+	
+}
+
+
+void SDL_SpriteBatch::draw(SDL_Texture *texture, const SDL_FRect *src, const SDL_FRect &dst,
+                           SDL_FColor color, SDL_BlendMode blend, int layer) {
+	
+	// corners in index order 0-1-2-3: top left, top right, bottom right, bottom left
+	SDL_FPoint corners[4] = {
+		{dst.x,         dst.y},
+		{dst.x + dst.w, dst.y},
+		{dst.x + dst.w, dst.y + dst.h},
+		{dst.x,         dst.y + dst.h}
+	};
+	
+	push_quad(texture, src, corners, color, blend, layer);
+	
+}
+
+
+void SDL_SpriteBatch::draw(const SDL_TextureRegion &region, const SDL_FRect &dst,
+                           SDL_FColor color, SDL_BlendMode blend, int layer) {
+	draw(region.texture, &region.src, dst, color, blend, layer);
+}
+
+
+void SDL_SpriteBatch::draw_rotated(SDL_Texture *texture, const SDL_FRect *src, const SDL_FRect &dst,
+                                   double angle, const SDL_FPoint *center,
+                                   SDL_FColor color, SDL_BlendMode blend, int layer) {
+	
+	// rotation pivot relative to dst, defaults to dst center (same as SDL_RenderTextureRotated)
+	float cx = center ? center->x : dst.w * 0.5f;
+	float cy = center ? center->y : dst.h * 0.5f;
+	
+	float rad = (float)(angle * SDL_PI_D / 180.0);
+	float c = cosf(rad);
+	float s = sinf(rad);
+	
+	float local[4][2] = {
+		{-cx,         -cy},
+		{dst.w - cx,  -cy},
+		{dst.w - cx,  dst.h - cy},
+		{-cx,         dst.h - cy}
+	};
+	
+	SDL_FPoint corners[4];
+	for (int i = 0; i < 4; i++) {
+		corners[i].x = dst.x + cx + local[i][0] * c - local[i][1] * s;
+		corners[i].y = dst.y + cy + local[i][0] * s + local[i][1] * c;
+	}
+	
+	push_quad(texture, src, corners, color, blend, layer);
+	
+}
+
+
+void SDL_SpriteBatch::push_quad(SDL_Texture *texture, const SDL_FRect *src, const SDL_FPoint corners[4],
+                                SDL_FColor color, SDL_BlendMode blend, int layer) {
+	
+	// source rect in texels - normalized in flush(), where texture size can be queried on the render thread
+	float u0 = 0.0f, v0 = 0.0f, u1 = 1.0f, v1 = 1.0f;
+	bool pixel_uv = texture && src;
+	
+	if (pixel_uv) {
+		u0 = src->x;
+		v0 = src->y;
+		u1 = src->x + src->w;
+		v1 = src->y + src->h;
+	}
+	
+	Sprite sprite;
+	sprite.texture = texture;
+	sprite.blend = blend;
+	sprite.layer = layer;
+	sprite.first_vertex = (int)staged.size();
+	sprite.pixel_uv = pixel_uv;
+	sprites.push_back(sprite);
+	
+	staged.push_back({corners[0], color, {u0, v0}});
+	staged.push_back({corners[1], color, {u1, v0}});
+	staged.push_back({corners[2], color, {u1, v1}});
+	staged.push_back({corners[3], color, {u0, v1}});
+	
+}
+
+
+void SDL_SpriteBatch::flush(SDL_Renderer *renderer, bool clear_after) {
+	
+	last_sprites = (int)sprites.size();
+	last_vertices = 0;
+	last_draw_calls = 0;
+	
+	if (sprites.empty()) {
+		return;
+	}
+	
+	// sort sprite indices by group key - stable so overlapping sprites within a group keep their order
+	order.resize(sprites.size());
+	for (uint32_t i = 0; i < (uint32_t)order.size(); i++) {
+		order[i] = i;
+	}
+	
+	std::stable_sort(order.begin(), order.end(), [this](uint32_t a, uint32_t b) {
+		const Sprite &sa = sprites[a];
+		const Sprite &sb = sprites[b];
+		if (sa.layer != sb.layer) return sa.layer < sb.layer;
+		if (sa.texture != sb.texture) return std::less<SDL_Texture*>()(sa.texture, sb.texture); // built-in < on unrelated pointers is unspecified
+		return sa.blend < sb.blend;
+	});
+	
+	// gather vertices into sorted, contiguous buffer - texture sizes hit the cache once per group
+	vertices.resize(staged.size());
+	for (size_t i = 0; i < order.size(); i++) {
+		
+		const Sprite &sprite = sprites[order[i]];
+		const SDL_Vertex *quad = &staged[sprite.first_vertex];
+		SDL_Vertex *out = &vertices[i * 4];
+		std::copy(quad, quad + 4, out);
+		
+		if (sprite.pixel_uv) {
+			float tw, th;
+			texture_size(sprite.texture, &tw, &th);
+			if (tw > 0.0f && th > 0.0f) {
+				for (int k = 0; k < 4; k++) {
+					out[k].tex_coord.x /= tw;
+					out[k].tex_coord.y /= th;
+				}
+			}
+		}
+	}
+	
+	// extend shared index pattern (0 1 2, 2 3 0 per quad) to cover largest group
+	size_t quads_indexed = indices.size() / 6;
+	for (size_t q = quads_indexed; q < sprites.size(); q++) {
+		int base = (int)(q * 4);
+		indices.push_back(base);
+		indices.push_back(base + 1);
+		indices.push_back(base + 2);
+		indices.push_back(base + 2);
+		indices.push_back(base + 3);
+		indices.push_back(base);
+	}
+	
+	// one geometry call per run of equal group keys
+	size_t start = 0;
+	while (start < order.size()) {
+		
+		const Sprite &first = sprites[order[start]];
+		
+		size_t end = start + 1;
+		while (end < order.size()) {
+			const Sprite &s = sprites[order[end]];
+			if (s.layer != first.layer || s.texture != first.texture || s.blend != first.blend) break;
+			end++;
+		}
+		
+		int quads = (int)(end - start);
+		
+		if (first.texture) {
+			SDL_SetTextureBlendMode(first.texture, first.blend);
+		}
+		
+		if (!SDL_RenderGeometry(renderer, first.texture, &vertices[start * 4], quads * 4, indices.data(), quads * 6)) {
+			fprintf(stderr, "Error rendering sprite batch: %s\n", SDL_GetError());
+		}
+		
+		last_vertices += quads * 4;
+		last_draw_calls++;
+		
+		start = end;
+	}
+	
+	if (clear_after) {
+		clear();
+	}
+	else {
+		size_texture = NULL; // kept for another flush - textures may still change in between
+	}
+	
+}
+
+
+void SDL_SpriteBatch::clear() {
+	// keeps capacity - no allocation once batch size has stabilized
+	sprites.clear();
+	staged.clear();
+	
+	size_texture = NULL; // textures may be destroyed between frames
+}
+
+
+void SDL_SpriteBatch::texture_size(SDL_Texture *texture, float *w, float *h) {
+	
+	if (texture != size_texture) {
+		if (!SDL_GetTextureSize(texture, &size_w, &size_h)) {
+			size_w = 0.0f;
+			size_h = 0.0f;
+		}
+		size_texture = texture;
+	}
+	
+	*w = size_w;
+	*h = size_h;
+}
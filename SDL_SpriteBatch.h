@@ -0,0 +1,79 @@
+#ifndef SDL_SPRITEBATCH_H
+#define SDL_SPRITEBATCH_H
+
+#include <SDL3/SDL.h>
+
+#include <vector>
+
+#include <stdint.h>
+
+// Part of a texture - whole texture or one image of an atlas page
+struct SDL_TextureRegion {
+	SDL_Texture *texture;
+	SDL_FRect src;
+};
+
+// Collects textured quads during draw_ext() and submits them with one
+// SDL_RenderGeometry call per (layer, texture, blend mode) group on flush().
+// Sprites within a group keep submission order; groups are ordered by layer
+// first, so use layers where sprites of different textures must overlap
+// in a fixed order.
+class SDL_SpriteBatch {
+	
+	struct Sprite {
+		SDL_Texture *texture;
+		SDL_BlendMode blend;
+		int layer;
+		int first_vertex; // index of first of 4 vertices in staged
+		bool pixel_uv;    // staged tex coords are in texels, normalized at flush
+	};
+	
+	std::vector<Sprite> sprites;
+	std::vector<SDL_Vertex> staged;   // 4 vertices per sprite, submission order - recording needs no renderer
+	std::vector<uint32_t> order;      // sprite indices sorted by layer/texture/blend
+	std::vector<SDL_Vertex> vertices; // sorted, contiguous vertex buffer
+	std::vector<int> indices;         // shared quad index pattern, grows on demand
+	
+	// texture size cache for uv calculation - consecutive draws usually share a texture
+	SDL_Texture *size_texture;
+	float size_w;
+	float size_h;
+	
+	// stats of last flush
+	int last_sprites;
+	int last_vertices;
+	int last_draw_calls;
+	
+	public:
+		SDL_SpriteBatch();
+		
+		void draw(SDL_Texture *texture, const SDL_FRect *src, const SDL_FRect &dst,
+		          SDL_FColor color = {1.0f, 1.0f, 1.0f, 1.0f},
+		          SDL_BlendMode blend = SDL_BLENDMODE_BLEND, int layer = 0);
+		
+		void draw(const SDL_TextureRegion &region, const SDL_FRect &dst,
+		          SDL_FColor color = {1.0f, 1.0f, 1.0f, 1.0f},
+		          SDL_BlendMode blend = SDL_BLENDMODE_BLEND, int layer = 0);
+		
+		void draw_rotated(SDL_Texture *texture, const SDL_FRect *src, const SDL_FRect &dst,
+		                  double angle, const SDL_FPoint *center = NULL,
+		                  SDL_FColor color = {1.0f, 1.0f, 1.0f, 1.0f},
+		                  SDL_BlendMode blend = SDL_BLENDMODE_BLEND, int layer = 0);
+		
+		void flush(SDL_Renderer *renderer, bool clear_after = true);
+		void clear();
+		
+		int pending() const { return (int)sprites.size(); }
+		
+		int sprites_drawn() const { return last_sprites; }
+		int vertices_drawn() const { return last_vertices; }
+		int draw_calls() const { return last_draw_calls; }
+		
+	private:
+		void push_quad(SDL_Texture *texture, const SDL_FRect *src, const SDL_FPoint corners[4],
+		               SDL_FColor color, SDL_BlendMode blend, int layer);
+		void texture_size(SDL_Texture *texture, float *w, float *h);
+	
+};
+
+#endif
@@ -0,0 +1,332 @@
+#include "SDL_TextCache.h"
+
+#include <stdio.h>
+
+
+SDL_TextCache::SDL_TextCache() {
+	
+	renderer = NULL;
+	ttf_held = false;
+	run_count = 0;
+	
+	glyph_hits = 0;
+	glyph_misses = 0;
+	run_hits = 0;
+	run_misses = 0;
+	
+}
+
+
+SDL_TextCache::~SDL_TextCache() {
+	clear();
+}
+
+
+void SDL_TextCache::set_renderer(SDL_Renderer *r) {
+	renderer = r;
+}
+
+
+int SDL_TextCache::open_font(const std::string &path, float size, TTF_FontStyleFlags style) {
+	
+	for (size_t i = 0; i < fonts.size(); i++) { // already open at this size and style
+		if (fonts[i].path == path && fonts[i].size == size && fonts[i].style == style) {
+			return (int)i;
+		}
+	}
+	
+	// ttf starts with the first font rather than with the application
+	if (!ttf_held) {
+		if (!SDL_Runtime::instance().acquire_text()) {
+			return -1;
+		}
+		ttf_held = true;
+	}
+	
+	TTF_Font *font = TTF_OpenFont(path.c_str(), size);
+	if (!font) {
+		fprintf(stderr, "Error opening font \"%s\": %s\n", path.c_str(), SDL_GetError());
+		return -1;
+	}
+	
+	TTF_SetFontStyle(font, style);
+	
+	fonts.push_back({path, size, style, font, TTF_GetFontLineSkip(font)});
+	runs.emplace_back();
+	
+	return (int)fonts.size() - 1;
+	
+}
+
+
+void SDL_TextCache::draw(SDL_SpriteBatch &batch, int font, const std::string &text, float x, float y,
+                         SDL_FColor color, int layer) {
+	
+	const Run *run = layout(font, text);
+	if (!run) {
+		return;
+	}
+	
+	for (const Quad &quad : run->quads) {
+		SDL_FRect dst = {x + quad.dst.x, y + quad.dst.y, quad.dst.w, quad.dst.h};
+		batch.draw(quad.region, dst, color, SDL_BLENDMODE_BLEND, layer);
+	}
+	
+}
+
+
+SDL_FPoint SDL_TextCache::measure(int font, const std::string &text) {
+	
+	const Run *run = layout(font, text);
+	if (!run) {
+		return {0.0f, 0.0f};
+	}
+	
+	return {run->width, run->height};
+}
+
+
+void SDL_TextCache::clear() {
+	
+	for (Page &page : pages) {
+		SDL_DestroyTexture(page.texture);
+	}
+	pages.clear();
+	
+	for (Font &font : fonts) {
+		TTF_CloseFont(font.font);
+	}
+	fonts.clear();
+	
+	glyphs.clear();
+	runs.clear();
+	run_count = 0;
+	
+	if (ttf_held) { // fonts are closed - ttf may go offline
+		SDL_Runtime::instance().release_text();
+		ttf_held = false;
+	}
+	
+}
+
+
+float SDL_TextCache::atlas_occupancy() const {
+	
+	if (pages.empty()) {
+		return 0.0f;
+	}
+	
+	float total = 0.0f;
+	for (const Page &page : pages) {
+		total += page.packer.occupancy();
+	}
+	
+	return total / (float)pages.size();
+}
+
+
+const SDL_TextCache::Run *SDL_TextCache::layout(int font, const std::string &text) {
+	
+	if (font < 0 || font >= (int)fonts.size()) {
+		return NULL;
+	}
+	
+	std::unordered_map<std::string, Run> &font_runs = runs[font];
+	
+	auto found = font_runs.find(text);
+	if (found != font_runs.end()) { // unchanged text - no shaping, no rasterization
+		run_hits++;
+		return &found->second;
+	}
+	
+	run_misses++;
+	
+	if (run_count >= max_runs) { // mostly one-off strings - start over rather than track recency
+		for (auto &r : runs) {
+			r.clear();
+		}
+		run_count = 0;
+	}
+	
+	Font &f = fonts[font];
+	Run &run = font_runs[text];
+	run_count++;
+	
+	float pen_x = 0.0f;
+	float pen_y = 0.0f;
+	float width = 0.0f;
+	Uint32 previous = 0;
+	
+	size_t i = 0;
+	while (i < text.size()) {
+		
+		Uint32 ch = next_codepoint(text, &i);
+		
+		if (ch == '\n') {
+			pen_x = 0.0f;
+			pen_y += (float)f.line_skip;
+			previous = 0;
+			continue;
+		}
+		
+		int kerning = 0;
+		if (previous && TTF_GetGlyphKerning(f.font, previous, ch, &kerning)) {
+			pen_x += (float)kerning;
+		}
+		
+		const Glyph &g = glyph(font, ch);
+		
+		if (g.region.texture) {
+			run.quads.push_back({g.region, {pen_x, pen_y, g.region.src.w, g.region.src.h}});
+		}
+		
+		pen_x += (float)g.advance;
+		if (pen_x > width) {
+			width = pen_x;
+		}
+		previous = ch;
+	}
+	
+	run.width = width;
+	run.height = pen_y + (float)f.line_skip;
+	
+	return &run;
+	
+}
+
+
+const SDL_TextCache::Glyph &SDL_TextCache::glyph(int font, Uint32 codepoint) {
+	
+	uint64_t key = ((uint64_t)font << 32) | codepoint;
+	
+	auto found = glyphs.find(key);
+	if (found != glyphs.end()) {
+		glyph_hits++;
+		return found->second;
+	}
+	
+	glyph_misses++;
+	
+	Glyph &g = glyphs[key];
+	g.region = {NULL, {0.0f, 0.0f, 0.0f, 0.0f}};
+	g.advance = 0;
+	
+	TTF_Font *ttf = fonts[font].font;
+	
+	int minx, maxx, miny, maxy;
+	if (!TTF_GetGlyphMetrics(ttf, codepoint, &minx, &maxx, &miny, &maxy, &g.advance)) {
+		return g; // not in font - zero width
+	}
+	
+	// rendered white, cell is advance wide and font height tall, so it sits at the pen position
+	SDL_Surface *surface = TTF_RenderGlyph_Blended(ttf, codepoint, {255, 255, 255, 255});
+	if (!surface || surface->w == 0 || surface->h == 0) { // blank glyph
+		if (surface) SDL_DestroySurface(surface);
+		return g;
+	}
+	
+	SDL_Surface *rgba = surface;
+	if (surface->format != SDL_PIXELFORMAT_RGBA32) {
+		rgba = SDL_ConvertSurface(surface, SDL_PIXELFORMAT_RGBA32);
+	}
+	
+	SDL_Texture *texture;
+	SDL_Rect rect;
+	
+	// 1px gap between glyphs against filtering bleed
+	if (rgba && pack(rgba->w + 1, rgba->h + 1, &texture, &rect)) {
+		SDL_Rect dst = {rect.x, rect.y, rgba->w, rgba->h};
+		if (SDL_UpdateTexture(texture, &dst, rgba->pixels, rgba->pitch)) {
+			g.region.texture = texture;
+			g.region.src = {(float)dst.x, (float)dst.y, (float)dst.w, (float)dst.h};
+		}
+	}
+	
+	if (rgba && rgba != surface) {
+		SDL_DestroySurface(rgba);
+	}
+	SDL_DestroySurface(surface);
+	
+	return g;
+	
+}
+
+
+bool SDL_TextCache::pack(int w, int h, SDL_Texture **texture, SDL_Rect *rect) {
+	
+	// would not fit an empty page either - don't open one for it
+	if (w > page_size || h > page_size) {
+		fprintf(stderr, "Error - %dx%d glyph is larger than the %d glyph atlas page, drawn blank.\n", w, h, page_size);
+		return false;
+	}
+	
+	if (!pages.empty() && pages.back().packer.pack(w, h, rect)) {
+		*texture = pages.back().texture;
+		return true;
+	}
+	
+	if (!renderer) {
+		fprintf(stderr, "Error - text cache has no renderer.\n");
+		return false;
+	}
+	
+	SDL_Texture *page_texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_STATIC, page_size, page_size);
+	if (!page_texture) {
+		fprintf(stderr, "Error creating glyph atlas: %s\n", SDL_GetError());
+		return false;
+	}
+	
+	// static texture contents are undefined - clear once so gaps stay transparent
+	std::vector<Uint8> blank((size_t)page_size * page_size * 4, 0);
+	SDL_UpdateTexture(page_texture, NULL, blank.data(), page_size * 4);
+	SDL_SetTextureBlendMode(page_texture, SDL_BLENDMODE_BLEND);
+	
+	Page page;
+	page.texture = page_texture;
+	page.packer.reset(page_size, page_size);
+	pages.push_back(page);
+	
+	if (!pages.back().packer.pack(w, h, rect)) {
+		return false;
+	}
+	
+	*texture = page_texture;
+	return true;
+	
+}
+
+
+Uint32 SDL_TextCache::next_codepoint(const std::string &text, size_t *i) {
+	
+	// utf-8 decode, invalid bytes come out as U+FFFD
+	const unsigned char *s = (const unsigned char *)text.data();
+	size_t n = text.size();
+	unsigned char c = s[*i];
+	
+	int length;
+	Uint32 cp;
+	
+	if (c < 0x80)              { length = 1; cp = c; }
+	else if ((c >> 5) == 0x06) { length = 2; cp = c & 0x1F; }
+	else if ((c >> 4) == 0x0E) { length = 3; cp = c & 0x0F; }
+	else if ((c >> 3) == 0x1E) { length = 4; cp = c & 0x07; }
+	else                       { (*i)++; return 0xFFFD; }
+	
+	if (*i + length > n) {
+		*i = n;
+		return 0xFFFD;
+	}
+	
+	for (int k = 1; k < length; k++) {
+		unsigned char cc = s[*i + k];
+		if ((cc >> 6) != 0x02) {
+			(*i)++;
+			return 0xFFFD;
+		}
+		cp = (cp << 6) | (cc & 0x3F);
+	}
+	
+	*i += length;
+	return cp;
+	
+}
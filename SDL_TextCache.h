@@ -0,0 +1,102 @@
+#ifndef SDL_TEXTCACHE_H
+#define SDL_TEXTCACHE_H
+
+#include <SDL3/SDL.h>
+#include <SDL3_ttf/SDL_ttf.h>
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "SDL_AtlasPacker.h"
+#include "SDL_Runtime.h"
+#include "SDL_SpriteBatch.h"
+
+// Text rendering through a glyph atlas. Each glyph is rasterized once per font
+// (path, size, style) into shared atlas pages; laid-out strings are cached as
+// runs of quads, so redrawing unchanged text only pushes quads into a sprite
+// batch. Glyphs are rendered white and tinted through the vertex color.
+class SDL_TextCache {
+	
+	struct Font {
+		std::string path;
+		float size;
+		TTF_FontStyleFlags style;
+		TTF_Font *font;
+		int line_skip;
+	};
+	
+	struct Glyph {
+		SDL_TextureRegion region; // texture NULL for blank glyphs (space)
+		int advance;
+	};
+	
+	struct Quad {
+		SDL_TextureRegion region;
+		SDL_FRect dst; // relative to run origin
+	};
+	
+	struct Run {
+		std::vector<Quad> quads;
+		float width;
+		float height;
+	};
+	
+	struct Page {
+		SDL_Texture *texture;
+		SDL_AtlasPacker packer;
+	};
+	
+	SDL_Renderer *renderer;
+	bool ttf_held; // runtime text reference, taken with the first font
+	
+	std::vector<Font> fonts;
+	std::vector<Page> pages;
+	std::unordered_map<uint64_t, Glyph> glyphs;             // key: font << 32 | codepoint
+	std::vector<std::unordered_map<std::string, Run>> runs; // per font, keyed by text
+	size_t run_count;
+	
+	// stats
+	uint64_t glyph_hits;
+	uint64_t glyph_misses; // = glyphs rasterized
+	uint64_t run_hits;
+	uint64_t run_misses;
+	
+	public:
+		// Default values - change before first use
+		int page_size = 512;
+		size_t max_runs = 4096; // run cache is dropped when it grows past this
+		
+		SDL_TextCache();
+		~SDL_TextCache();
+		
+		// owns fonts and atlas pages - a copy would free them twice
+		SDL_TextCache(const SDL_TextCache &) = delete;
+		SDL_TextCache &operator=(const SDL_TextCache &) = delete;
+		
+		void set_renderer(SDL_Renderer *r);
+		
+		int open_font(const std::string &path, float size, TTF_FontStyleFlags style = TTF_STYLE_NORMAL);
+		
+		void draw(SDL_SpriteBatch &batch, int font, const std::string &text, float x, float y,
+		          SDL_FColor color = {1.0f, 1.0f, 1.0f, 1.0f}, int layer = 0);
+		SDL_FPoint measure(int font, const std::string &text);
+		
+		void clear();
+		
+		uint64_t glyph_cache_hits() const { return glyph_hits; }
+		uint64_t glyph_cache_misses() const { return glyph_misses; }
+		uint64_t run_cache_hits() const { return run_hits; }
+		uint64_t run_cache_misses() const { return run_misses; }
+		int page_count() const { return (int)pages.size(); }
+		float atlas_occupancy() const; // packed fraction of all pages
+		
+	private:
+		const Run *layout(int font, const std::string &text);
+		const Glyph &glyph(int font, Uint32 codepoint);
+		bool pack(int w, int h, SDL_Texture **texture, SDL_Rect *rect);
+		static Uint32 next_codepoint(const std::string &text, size_t *i);
+	
+};
+
+#endif
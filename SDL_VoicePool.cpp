@@ -0,0 +1,152 @@
+#include "SDL_VoicePool.h"
+
+#include <stdio.h>
+
+
+SDL_VoicePool::SDL_VoicePool() {
+	
+	sequence = 0;
+	
+	current = {0, 0, 0, 0};
+	last = current;
+	
+}
+
+
+SDL_VoicePool::~SDL_VoicePool() {
+	destroy();
+}
+
+
+bool SDL_VoicePool::create(MIX_Mixer *mixer, int count) {
+	
+	destroy();
+	
+	voices.reserve(count);
+	
+	for (int i = 0; i < count; i++) {
+		
+		MIX_Track *track = MIX_CreateTrack(mixer);
+		if (!track) {
+			fprintf(stderr, "Error creating sfx voice: %s\n", SDL_GetError());
+			return false;
+		}
+		
+		voices.push_back({track, 0, 0, 0.0f});
+	}
+	
+	return true;
+	
+}
+
+
+void SDL_VoicePool::destroy() {
+	
+	for (Voice &voice : voices) {
+		MIX_DestroyTrack(voice.track);
+	}
+	voices.clear();
+	
+}
+
+
+bool SDL_VoicePool::play(MIX_Audio *audio, int priority, float gain) {
+	
+	int index = pick_voice(priority);
+	if (index < 0) {
+		current.dropped++;
+		return false;
+	}
+	
+	Voice &voice = voices[index];
+	
+	if (!MIX_SetTrackAudio(voice.track, audio)) {
+		fprintf(stderr, "Error setting sfx track: %s\n", SDL_GetError());
+		return false;
+	}
+	
+	MIX_SetTrackGain(voice.track, gain);
+	
+	if (!MIX_PlayTrack(voice.track, 0)) {
+		fprintf(stderr, "Error playing sfx: %s\n", SDL_GetError());
+		return false;
+	}
+	
+	voice.sequence = ++sequence;
+	voice.priority = priority;
+	voice.gain = gain;
+	
+	current.plays++;
+	return true;
+	
+}
+
+
+void SDL_VoicePool::stop_all() {
+	for (Voice &voice : voices) {
+		MIX_StopTrack(voice.track, 0);
+	}
+}
+
+
+void SDL_VoicePool::begin_frame() {
+	
+	last = current;
+	
+	current = {0, 0, 0, 0};
+	for (Voice &voice : voices) {
+		if (MIX_TrackPlaying(voice.track)) {
+			current.active++;
+		}
+	}
+	
+}
+
+
+int SDL_VoicePool::pick_voice(int priority) {
+	
+	// free voice first
+	for (size_t i = 0; i < voices.size(); i++) {
+		if (!MIX_TrackPlaying(voices[i].track)) {
+			return (int)i;
+		}
+	}
+	
+	if (policy == SDL_STEAL_NONE || voices.empty()) {
+		return -1;
+	}
+	
+	// all busy - pick victim by policy, oldest wins ties
+	int victim = 0;
+	
+	for (size_t i = 1; i < voices.size(); i++) {
+		
+		const Voice &v = voices[i];
+		const Voice &best = voices[victim];
+		bool older = v.sequence < best.sequence;
+		
+		switch (policy) {
+			
+			case SDL_STEAL_QUIETEST:
+				if (v.gain < best.gain || (v.gain == best.gain && older)) victim = (int)i;
+				break;
+			
+			case SDL_STEAL_LOWEST_PRIORITY:
+				if (v.priority < best.priority || (v.priority == best.priority && older)) victim = (int)i;
+				break;
+			
+			default: // SDL_STEAL_OLDEST
+				if (older) victim = (int)i;
+				break;
+		}
+	}
+	
+	// never cut off something more important than the new sound
+	if (policy == SDL_STEAL_LOWEST_PRIORITY && voices[victim].priority > priority) {
+		return -1;
+	}
+	
+	current.steals++;
+	return victim;
+	
+}
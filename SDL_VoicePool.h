@@ -0,0 +1,73 @@
+#ifndef SDL_VOICEPOOL_H
+#define SDL_VOICEPOOL_H
+
+#include <SDL3/SDL.h>
+#include <SDL3_mixer/SDL_mixer.h>
+
+#include <vector>
+
+#include <stdint.h>
+
+#ifndef SFX_DEFAULT_VOICES
+#define SFX_DEFAULT_VOICES 16
+#endif
+
+// what play() does when every voice is busy
+enum SDL_StealPolicy {
+	SDL_STEAL_OLDEST,           // cut off the voice that started first
+	SDL_STEAL_QUIETEST,         // cut off the voice with the lowest gain
+	SDL_STEAL_LOWEST_PRIORITY,  // cut off the lowest priority voice, if not above the new sound
+	SDL_STEAL_NONE              // drop the new sound
+};
+
+struct SDL_VoiceStats {
+	int active;  // voices playing at start of frame
+	int plays;   // sounds started
+	int steals;  // sounds cut off to make room
+	int dropped; // sounds not started because no voice could be taken
+};
+
+// Fixed set of mixer tracks for overlapping sound effects. Tracks are created
+// up front, so play() neither creates tracks nor allocates.
+class SDL_VoicePool {
+	
+	struct Voice {
+		MIX_Track *track;
+		uint64_t sequence; // play order - lower is older
+		int priority;
+		float gain;
+	};
+	
+	std::vector<Voice> voices;
+	uint64_t sequence;
+	
+	SDL_VoiceStats current;
+	SDL_VoiceStats last;
+	
+	public:
+		SDL_StealPolicy policy = SDL_STEAL_OLDEST;
+		
+		SDL_VoicePool();
+		~SDL_VoicePool();
+		
+		// owns its mixer tracks - a copy would destroy them twice
+		SDL_VoicePool(const SDL_VoicePool &) = delete;
+		SDL_VoicePool &operator=(const SDL_VoicePool &) = delete;
+		
+		bool create(MIX_Mixer *mixer, int count = SFX_DEFAULT_VOICES);
+		void destroy();
+		
+		bool play(MIX_Audio *audio, int priority = 0, float gain = 1.0f);
+		void stop_all();
+		
+		void begin_frame();
+		
+		int voice_count() const { return (int)voices.size(); }
+		const SDL_VoiceStats &frame_stats() const { return last; } // stats of previous frame
+		
+	private:
+		int pick_voice(int priority);
+	
+};
+
+#endif
@@ -0,0 +1,160 @@
+#include "SDL_World.h"
+
+#include <stdio.h>
+
+
+SDL_World::SDL_World() {
+	
+	alive_count = 0;
+	phases_dirty = false;
+	
+	for (std::atomic<SDL_ComponentPoolBase*> &p : pools) {
+		p.store(NULL, std::memory_order_relaxed);
+	}
+	
+}
+
+
+SDL_World::~SDL_World() {
+	
+	for (std::atomic<SDL_ComponentPoolBase*> &p : pools) {
+		delete p.load(std::memory_order_relaxed);
+	}
+	
+}
+
+
+SDL_Entity SDL_World::create() {
+	
+	uint32_t index;
+	
+	if (!free_indices.empty()) {
+		index = free_indices.back();
+		free_indices.pop_back();
+	}
+	else {
+		if (generations.size() >= 0xFFFFFF) {
+			fprintf(stderr, "Error - world is full.\n");
+			return SDL_ENTITY_INVALID;
+		}
+		index = (uint32_t)generations.size();
+		generations.push_back(1);
+	}
+	
+	alive_count++;
+	
+	return ((SDL_Entity)generations[index] << 24) | index;
+	
+}
+
+
+void SDL_World::destroy(SDL_Entity e) {
+	
+	if (!alive(e)) {
+		return;
+	}
+	
+	uint32_t index = SDL_ENTITY_INDEX(e);
+	
+	for (std::atomic<SDL_ComponentPoolBase*> &slot : pools) {
+		SDL_ComponentPoolBase *p = slot.load(std::memory_order_acquire);
+		if (p) {
+			p->remove(index);
+		}
+	}
+	
+	// invalidate outstanding handles, skip 0 so no handle equals SDL_ENTITY_INVALID
+	generations[index]++;
+	if (generations[index] == 0) {
+		generations[index] = 1;
+	}
+	
+	free_indices.push_back(index);
+	alive_count--;
+	
+}
+
+
+bool SDL_World::alive(SDL_Entity e) const {
+	
+	uint32_t index = SDL_ENTITY_INDEX(e);
+	
+	// destroy() bumps the generation, so handles to destroyed entities never match
+	return e != SDL_ENTITY_INVALID && index < generations.size() && generations[index] == SDL_ENTITY_GENERATION(e);
+}
+
+
+void SDL_World::add_system(const char *name, uint64_t reads, uint64_t writes, std::function<void(SDL_World &, double)> fn) {
+	systems.push_back({name, reads, writes, fn});
+	phases_dirty = true;
+}
+
+
+void SDL_World::update(double delta) {
+	
+	if (systems.empty()) {
+		return;
+	}
+	
+	if (phases_dirty) {
+		build_phases();
+	}
+	
+	for (const std::vector<int> &phase : phases) {
+		
+		if (phase.size() == 1) { // nothing to overlap with - run on this thread
+			systems[phase[0]].fn(*this, delta);
+			continue;
+		}
+		
+		jobs.parallel_for((int)phase.size(), 1, [&](int begin, int end) {
+			for (int i = begin; i < end; i++) {
+				systems[phase[i]].fn(*this, delta);
+			}
+		});
+	}
+	
+}
+
+
+int SDL_World::phase_count() {
+	
+	if (phases_dirty) {
+		build_phases();
+	}
+	
+	return (int)phases.size();
+}
+
+
+void SDL_World::build_phases() {
+	
+	// each system goes into the phase after the last one holding a system it conflicts with,
+	// so conflicting systems keep registration order and independent ones share a phase
+	phases.clear();
+	std::vector<int> phase_of(systems.size(), 0);
+	
+	for (size_t s = 0; s < systems.size(); s++) {
+		
+		const System &a = systems[s];
+		int target = 0;
+		
+		for (size_t o = 0; o < s; o++) {
+			const System &b = systems[o];
+			bool conflict = (a.writes & (b.reads | b.writes)) || (b.writes & a.reads);
+			if (conflict && phase_of[o] + 1 > target) {
+				target = phase_of[o] + 1;
+			}
+		}
+		
+		if (target >= (int)phases.size()) {
+			phases.resize(target + 1);
+		}
+		
+		phases[target].push_back((int)s);
+		phase_of[s] = target;
+	}
+	
+	phases_dirty = false;
+	
+}
@@ -0,0 +1,267 @@
+#ifndef SDL_WORLD_H
+#define SDL_WORLD_H
+
+#include <SDL3/SDL.h>
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <vector>
+
+#include <stdint.h>
+
+#include "SDL_JobPool.h"
+
+// Handle to an entity - index in low 24 bits, generation in high 8 bits.
+// Stale handles (entity destroyed, index reused) are not alive().
+typedef uint32_t SDL_Entity;
+#define SDL_ENTITY_INVALID ((SDL_Entity)0)
+#define SDL_ENTITY_INDEX(e) ((e) & 0xFFFFFF)
+#define SDL_ENTITY_GENERATION(e) ((e) >> 24)
+
+#define WORLD_MAX_COMPONENTS 64 // component types per process, one bit each in system masks
+
+
+class SDL_ComponentPoolBase {
+	public:
+		virtual ~SDL_ComponentPoolBase() {}
+		virtual void remove(uint32_t index) = 0;
+};
+
+
+// Sparse set - components of one type packed in a dense array, sparse maps
+// entity index to dense slot. Iteration walks the dense array only.
+template <typename T>
+class SDL_ComponentPool : public SDL_ComponentPoolBase {
+	
+	std::vector<uint32_t> sparse;     // entity index -> dense slot + 1, 0 = absent
+	std::vector<SDL_Entity> entities; // dense slot -> owner
+	std::vector<T> data;              // dense slot -> component
+	
+	public:
+		T &add(SDL_Entity e, const T &value) {
+			uint32_t index = SDL_ENTITY_INDEX(e);
+			if (index >= sparse.size()) {
+				sparse.resize(index + 1, 0);
+			}
+			if (sparse[index]) { // already has one - overwrite
+				return data[sparse[index] - 1] = value;
+			}
+			entities.push_back(e);
+			data.push_back(value);
+			sparse[index] = (uint32_t)data.size();
+			return data.back();
+		}
+		
+		T *get(uint32_t index) {
+			if (index >= sparse.size() || !sparse[index]) {
+				return NULL;
+			}
+			return &data[sparse[index] - 1];
+		}
+		
+		void remove(uint32_t index) override {
+			if (index >= sparse.size() || !sparse[index]) {
+				return;
+			}
+			// swap with last to keep dense array packed
+			uint32_t slot = sparse[index] - 1;
+			uint32_t last = (uint32_t)data.size() - 1;
+			if (slot != last) {
+				data[slot] = data[last];
+				entities[slot] = entities[last];
+				sparse[SDL_ENTITY_INDEX(entities[slot])] = slot + 1;
+			}
+			data.pop_back();
+			entities.pop_back();
+			sparse[index] = 0;
+		}
+		
+		int size() const { return (int)data.size(); }
+		T *components() { return data.data(); }
+		SDL_Entity entity(int slot) const { return entities[slot]; }
+	
+};
+
+
+// Entities, component pools and systems. Systems declare which component
+// types they read and write; update() runs them in registration order, with
+// systems that don't conflict grouped into phases that run in parallel on
+// the job pool. Creating or destroying entities and adding or removing
+// components is not thread safe - do it outside systems or in a system that
+// runs alone. Looking up pools (get(), each(), first use of a component type)
+// is safe from any thread.
+class SDL_World {
+	
+	struct System {
+		const char *name;
+		uint64_t reads;
+		uint64_t writes;
+		std::function<void(SDL_World &, double)> fn;
+	};
+	
+	std::vector<uint8_t> generations; // per entity index, 0 = never used
+	std::vector<uint32_t> free_indices;
+	int alive_count;
+	
+	// created on first use of a type, possibly from inside a parallel system - owned, freed in destructor
+	std::atomic<SDL_ComponentPoolBase*> pools[WORLD_MAX_COMPONENTS];
+	std::mutex pools_mutex;
+	
+	std::vector<System> systems;
+	std::vector<std::vector<int>> phases; // system indices per phase, rebuilt when systems change
+	bool phases_dirty;
+	
+	SDL_JobPool jobs;
+	
+	public:
+		SDL_World();
+		~SDL_World();
+		
+		SDL_Entity create();
+		void destroy(SDL_Entity e);
+		bool alive(SDL_Entity e) const;
+		int entity_count() const { return alive_count; }
+		
+		template <typename T> T *add(SDL_Entity e, const T &value = T()); // NULL if e is not alive
+		template <typename T> T *get(SDL_Entity e);
+		template <typename T> void remove(SDL_Entity e);
+		template <typename T> SDL_ComponentPool<T> &pool();
+		
+		// fn(SDL_Entity, A&, Rest&...) for every entity that has all listed components
+		template <typename A, typename... Rest, typename F> void each(F &&fn);
+		template <typename A, typename... Rest, typename F> void parallel_each(F &&fn, int grain = 4096);
+		
+		template <typename... T> static uint64_t mask();
+		
+		void add_system(const char *name, uint64_t reads, uint64_t writes, std::function<void(SDL_World &, double)> fn);
+		void update(double delta);
+		
+		int phase_count();
+		SDL_JobPool &job_pool() { return jobs; }
+		
+	private:
+		void build_phases();
+		
+		static int next_component_id();
+		template <typename T> static int component_id();
+	
+};
+
+
+inline int SDL_World::next_component_id() {
+	static std::atomic<int> next(0); // types may be first seen on several threads at once
+	return next.fetch_add(1);
+}
+
+
+template <typename T>
+int SDL_World::component_id() {
+	static const int id = next_component_id(); // assigned on first use of each type
+	SDL_assert(id < WORLD_MAX_COMPONENTS);
+	return id;
+}
+
+
+template <typename... T>
+uint64_t SDL_World::mask() {
+	uint64_t m = 0;
+	int ids[] = {0, component_id<T>()...};
+	for (size_t i = 1; i < sizeof(ids) / sizeof(ids[0]); i++) {
+		m |= (uint64_t)1 << ids[i];
+	}
+	return m;
+}
+
+
+template <typename T>
+SDL_ComponentPool<T> &SDL_World::pool() {
+	
+	std::atomic<SDL_ComponentPoolBase*> &slot = pools[component_id<T>()];
+	SDL_ComponentPoolBase *p = slot.load(std::memory_order_acquire);
+	
+	if (!p) { // first use - only creation takes the lock
+		std::lock_guard<std::mutex> lock(pools_mutex);
+		p = slot.load(std::memory_order_relaxed);
+		if (!p) {
+			p = new SDL_ComponentPool<T>();
+			slot.store(p, std::memory_order_release);
+		}
+	}
+	
+	return *static_cast<SDL_ComponentPool<T> *>(p);
+}
+
+
+template <typename T>
+T *SDL_World::add(SDL_Entity e, const T &value) {
+	if (!alive(e)) { // stale handle would write into whoever reuses the index
+		return NULL;
+	}
+	return &pool<T>().add(e, value);
+}
+
+
+template <typename T>
+T *SDL_World::get(SDL_Entity e) {
+	if (!alive(e)) {
+		return NULL;
+	}
+	return pool<T>().get(SDL_ENTITY_INDEX(e));
+}
+
+
+template <typename T>
+void SDL_World::remove(SDL_Entity e) {
+	if (alive(e)) {
+		pool<T>().remove(SDL_ENTITY_INDEX(e));
+	}
+}
+
+
+template <typename A, typename... Rest, typename F>
+void SDL_World::each(F &&fn) {
+	
+	// drive iteration from first pool, look the others up per entity
+	SDL_ComponentPool<A> &first = pool<A>();
+	A *data = first.components();
+	
+	for (int i = 0; i < first.size(); i++) {
+		SDL_Entity e = first.entity(i);
+		uint32_t index = SDL_ENTITY_INDEX(e);
+		std::tuple<Rest *...> others(pool<Rest>().get(index)...);
+		bool complete = true;
+		std::apply([&](auto *... p) { complete = ((p != NULL) && ... && true); }, others);
+		if (complete) {
+			std::apply([&](auto *... p) { fn(e, data[i], *p...); }, others);
+		}
+	}
+}
+
+
+template <typename A, typename... Rest, typename F>
+void SDL_World::parallel_each(F &&fn, int grain) {
+	
+	SDL_ComponentPool<A> &first = pool<A>();
+	A *data = first.components();
+	
+	// look pools up once, outside the jobs - pool() may create one
+	std::tuple<SDL_ComponentPool<Rest> *...> rest(&pool<Rest>()...);
+	
+	jobs.parallel_for(first.size(), grain, [&](int begin, int end) {
+		for (int i = begin; i < end; i++) {
+			SDL_Entity e = first.entity(i);
+			uint32_t index = SDL_ENTITY_INDEX(e);
+			std::tuple<Rest *...> others = std::apply([&](auto *... p) { return std::make_tuple(p->get(index)...); }, rest);
+			bool complete = true;
+			std::apply([&](auto *... p) { complete = ((p != NULL) && ... && true); }, others);
+			if (complete) {
+				std::apply([&](auto *... p) { fn(e, data[i], *p...); }, others);
+			}
+		}
+	});
+}
+
+#endif
@@ -0,0 +1,566 @@
+// Headless frame benchmark for SDL_Application. Runs each scenario for a fixed
+// number of frames on the offscreen/dummy video driver, the software renderer
+// and the dummy audio driver, then prints one JSON object per scenario.
+//
+//   SDL_Application_bench [scenario|all] [frames] [count]
+//
+// scenarios: sprites, texture_swaps, text, sfx_burst, pacing, on_demand, pipelined, startup
+//
+// pacing also checks the achieved frame period against target_fps and the cpu
+// time per frame, sfx_burst the play/steal counts and the voice ceiling; a
+// failed check makes the run exit non-zero.
+//
+// startup constructs and destroys the application [count] times instead of
+// running frames, and times what is now deferred (audio device, ttf) apart
+// from what the constructor still pays.
+
+#include "../SDL_Application.h"
+#include "SDL_BenchUtil.h"
+
+#include <atomic>
+#include <new>
+#include <string>
+#include <vector>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCH_DEFAULT_FRAMES 600
+#define BENCH_TEXTURES 8
+#define BENCH_TEXTURE_SIZE 32
+
+#define BENCH_PACING_FPS 60
+#define BENCH_PACING_TOLERANCE 0.05 // median frame period within 5% of 1 / target_fps
+#define BENCH_PACING_CPU_SHARE 0.5  // cpu time per frame below half the frame period
+
+
+// count c++ heap allocations so steady-state frames can be checked for zero
+static std::atomic<uint64_t> bench_allocations(0);
+
+void *operator new(size_t size) {
+	bench_allocations.fetch_add(1, std::memory_order_relaxed);
+	void *p = malloc(size ? size : 1);
+	if (!p) {
+		throw std::bad_alloc();
+	}
+	return p;
+}
+
+void operator delete(void *p) noexcept { free(p); }
+void operator delete(void *p, size_t) noexcept { free(p); }
+
+
+struct BenchResult {
+	std::vector<Uint64> period_ns; // full frame incl. pacing
+	std::vector<Uint64> work_ns;   // events/update/draw only
+	uint64_t allocations;
+	clock_t cpu;
+	int draw_calls;
+	int vertices;
+	uint64_t sfx_plays;
+	uint64_t sfx_steals;
+	uint64_t sfx_dropped;
+	uint64_t sfx_failed;   // play() calls that returned false
+	int sfx_max_active;
+	uint64_t skipped;
+	uint64_t glyph_misses; // glyphs rasterized after the first frame - 0 when text is fully cached
+	float atlas_occupancy;
+	double overlap;        // pipelined mode - share of update/render that ran concurrently
+};
+
+
+class BenchApp : public SDL_Application {
+	
+	std::string scenario;
+	int frames;
+	int count;
+	
+	BenchResult result;
+	uint64_t alloc_mark;
+	
+	// sprite state, structure of arrays
+	std::vector<float> xs, ys, vxs, vys;
+	SDL_Texture *textures[BENCH_TEXTURES];
+	
+	MIX_Audio *sfx;
+	
+	int font;        // glyph cache font, -1 = debug text
+	uint64_t glyph_mark;
+	std::vector<std::string> lines;
+	
+	public:
+		BenchApp(const char *s, int f, int c);
+		~BenchApp();
+		
+		void report();
+		bool check() const; // scenario expectations - false (with a message) if any fails
+		
+		// startup scenario - open what the constructor no longer does
+		bool open_audio_now() { return open_audio() != NULL; }
+		
+	private:
+		void events_ext() override;
+		void update_ext() override;
+		void draw_ext() override;
+		void record_ext(SDL_SpriteBatch &snapshot) override;
+		
+		void make_textures();
+	
+};
+
+
+BenchApp::BenchApp(const char *s, int f, int c) {
+	
+	scenario = s;
+	frames = f;
+	count = c;
+	
+	result.period_ns.reserve(frames);
+	result.work_ns.reserve(frames);
+	result.allocations = 0;
+	result.cpu = 0;
+	result.draw_calls = 0;
+	result.vertices = 0;
+	result.sfx_plays = 0;
+	result.sfx_steals = 0;
+	result.sfx_dropped = 0;
+	result.sfx_failed = 0;
+	result.sfx_max_active = 0;
+	result.skipped = 0;
+	result.glyph_misses = 0;
+	result.atlas_occupancy = 0.0f;
+	result.overlap = 0.0;
+	
+	for (int i = 0; i < BENCH_TEXTURES; i++) {
+		textures[i] = NULL;
+	}
+	sfx = NULL;
+	font = -1;
+	glyph_mark = 0;
+	
+	if (scenario == "sprites" || scenario == "texture_swaps" || scenario == "pipelined") {
+		
+		pipelined = scenario == "pipelined"; // same sprites as 'sprites', recorded on the simulation thread
+		make_textures();
+		
+		SDL_srand(1);
+		for (int i = 0; i < count; i++) {
+			xs.push_back(SDL_randf() * window_width);
+			ys.push_back(SDL_randf() * window_height);
+			vxs.push_back((SDL_randf() - 0.5f) * 200.0f);
+			vys.push_back((SDL_randf() - 0.5f) * 200.0f);
+		}
+	}
+	else if (scenario == "sfx_burst") {
+		
+		if (!open_audio()) {
+			throw std::runtime_error("Error opening bench audio device.\n");
+		}
+		
+		std::vector<Uint8> wav = bench_make_wav(200);
+		sfx = MIX_LoadAudio_IO(mixer, SDL_IOFromConstMem(wav.data(), wav.size()), true, true);
+		if (!sfx) {
+			throw std::runtime_error("Error creating bench audio.\n");
+		}
+	}
+	else if (scenario == "text") {
+		
+		// no font ships with the repo - glyph cache path needs SDL_BENCH_FONT, otherwise debug text
+		const char *path = SDL_getenv("SDL_BENCH_FONT");
+		if (path) {
+			font = text.open_font(path, 16.0f);
+		}
+		for (int i = 0; i < count; i++) {
+			lines.push_back("score " + std::to_string(i * 1337) + "  lives 3  level " + std::to_string(i % 10));
+		}
+	}
+	else if (scenario == "pacing") {
+		target_fps = BENCH_PACING_FPS;
+	}
+	else if (scenario == "on_demand") {
+		on_demand = true;
+		idle_timeout_ms = 16;
+	}
+	
+}
+
+
+BenchApp::~BenchApp() {
+	
+	for (int i = 0; i < BENCH_TEXTURES; i++) {
+		if (textures[i]) {
+			SDL_DestroyTexture(textures[i]);
+		}
+	}
+	
+	if (sfx) {
+		sfx_voices.stop_all();
+		MIX_DestroyAudio(sfx);
+	}
+	
+}
+
+
+void BenchApp::make_textures() {
+	
+	std::vector<Uint32> pixels(BENCH_TEXTURE_SIZE * BENCH_TEXTURE_SIZE);
+	
+	for (int t = 0; t < BENCH_TEXTURES; t++) {
+		
+		for (size_t i = 0; i < pixels.size(); i++) {
+			pixels[i] = 0xFF000000u | (Uint32)(t * 0x1F3A5B + i * 0x010203);
+		}
+		
+		textures[t] = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_STATIC, BENCH_TEXTURE_SIZE, BENCH_TEXTURE_SIZE);
+		if (!textures[t]) {
+			throw std::runtime_error("Error creating bench texture.\n");
+		}
+		SDL_UpdateTexture(textures[t], NULL, pixels.data(), BENCH_TEXTURE_SIZE * 4);
+	}
+	
+}
+
+
+void BenchApp::events_ext() {
+	
+	// frame_period_ns / frame_work_ns describe the frame that just ended
+	if (frame_count == 0) {
+		alloc_mark = bench_allocations.load();
+		result.cpu = clock();
+		return;
+	}
+	
+	if (frame_count == 1) { // first frame rasterizes and lays out everything
+		glyph_mark = text.glyph_cache_misses();
+	}
+	
+	if ((int)result.period_ns.size() < frames) {
+		result.period_ns.push_back(frame_period_ns);
+		result.work_ns.push_back(frame_work_ns);
+	}
+	
+	if ((int)result.period_ns.size() >= frames) {
+		result.allocations = bench_allocations.load() - alloc_mark;
+		result.cpu = clock() - result.cpu;
+		result.draw_calls = sprite_batch.draw_calls();
+		result.vertices = sprite_batch.vertices_drawn();
+		result.skipped = skipped_frames;
+		result.glyph_misses = text.glyph_cache_misses() - glyph_mark;
+		result.atlas_occupancy = text.atlas_occupancy();
+		result.overlap = pipeline_overlap;
+		is_running = false;
+	}
+	
+}
+
+
+void BenchApp::update_ext() {
+	
+	if (!xs.empty()) {
+		float dt = (float)delta;
+		for (size_t i = 0; i < xs.size(); i++) {
+			xs[i] += vxs[i] * dt;
+			ys[i] += vys[i] * dt;
+			if (xs[i] < 0.0f || xs[i] > window_width) vxs[i] = -vxs[i];
+			if (ys[i] < 0.0f || ys[i] > window_height) vys[i] = -vys[i];
+		}
+	}
+	
+	if (sfx) {
+		
+		// update() has rolled the pool over, so frame_stats() is the previous frame -
+		// frames 1..n collect the plays of frames 0..n-1, one per recorded period
+		if (frame_count >= 1 && frame_count <= (uint64_t)frames) {
+			const SDL_VoiceStats &stats = sfx_voices.frame_stats();
+			result.sfx_plays += stats.plays;
+			result.sfx_steals += stats.steals;
+			result.sfx_dropped += stats.dropped;
+			if (stats.active > result.sfx_max_active) {
+				result.sfx_max_active = stats.active;
+			}
+		}
+		
+		for (int i = 0; i < count; i++) {
+			if (!sfx_voices.play(sfx, i % 4, 0.25f + 0.75f * (float)(i % 8) / 7.0f)) {
+				result.sfx_failed++;
+			}
+		}
+	}
+	
+}
+
+
+void BenchApp::draw_ext() {
+	
+	if (scenario == "sprites") { // one texture - best case for batching
+		for (size_t i = 0; i < xs.size(); i++) {
+			sprite_batch.draw(textures[0], NULL, {xs[i], ys[i], 16.0f, 16.0f});
+		}
+	}
+	else if (scenario == "texture_swaps") { // texture changes every sprite in submission order
+		for (size_t i = 0; i < xs.size(); i++) {
+			sprite_batch.draw(textures[i % BENCH_TEXTURES], NULL, {xs[i], ys[i], 16.0f, 16.0f});
+		}
+	}
+	else if (scenario == "text" && font >= 0) { // hud-like static lines through the glyph cache
+		for (int i = 0; i < count; i++) {
+			text.draw(sprite_batch, font, lines[i], 4.0f + (i / 25) * 260.0f, 4.0f + (i % 25) * 20.0f);
+		}
+	}
+	else if (scenario == "text") {
+		char line[64];
+		for (int i = 0; i < count; i++) {
+			SDL_snprintf(line, sizeof(line), "line %03d frame %llu", i, (unsigned long long)frame_count);
+			SDL_RenderDebugText(renderer, 4.0f + (i / 50) * 180.0f, 4.0f + (i % 50) * 10.0f, line);
+		}
+	}
+	
+}
+
+
+void BenchApp::record_ext(SDL_SpriteBatch &snapshot) {
+	for (size_t i = 0; i < xs.size(); i++) {
+		snapshot.draw(textures[0], NULL, {xs[i], ys[i], 16.0f, 16.0f});
+	}
+}
+
+
+void BenchApp::report() {
+	
+	double total_s = 0.0;
+	for (Uint64 ns : result.period_ns) {
+		total_s += (double)ns / (double)SDL_NS_PER_SECOND;
+	}
+	
+	int n = (int)result.period_ns.size();
+	
+	printf("{\"scenario\":\"%s\",\"frames\":%d,\"count\":%d,"
+	       "\"fps\":%.2f,\"frame_p50_ms\":%.3f,\"frame_p95_ms\":%.3f,\"frame_p99_ms\":%.3f,"
+	       "\"work_p50_ms\":%.3f,\"cpu_ms_per_frame\":%.3f,\"allocs_per_frame\":%.3f,"
+	       "\"draw_calls\":%d,\"vertices\":%d,\"sfx_plays\":%llu,\"sfx_steals\":%llu,\"sfx_dropped\":%llu,\"sfx_max_active\":%d,\"skipped_frames\":%llu,"
+	       "\"glyph_misses\":%llu,\"glyph_atlas_occupancy\":%.3f,\"pipeline_overlap\":%.3f}\n",
+	       scenario.c_str(), n, count,
+	       total_s > 0.0 ? n / total_s : 0.0,
+	       bench_percentile_ms(result.period_ns, 0.50),
+	       bench_percentile_ms(result.period_ns, 0.95),
+	       bench_percentile_ms(result.period_ns, 0.99),
+	       bench_percentile_ms(result.work_ns, 0.50),
+	       n ? 1000.0 * (double)result.cpu / CLOCKS_PER_SEC / n : 0.0,
+	       n ? (double)result.allocations / n : 0.0,
+	       result.draw_calls, result.vertices,
+	       (unsigned long long)result.sfx_plays,
+	       (unsigned long long)result.sfx_steals,
+	       (unsigned long long)result.sfx_dropped,
+	       result.sfx_max_active,
+	       (unsigned long long)result.skipped,
+	       (unsigned long long)result.glyph_misses,
+	       result.atlas_occupancy,
+	       result.overlap);
+	fflush(stdout);
+	
+}
+
+
+bool BenchApp::check() const {
+	
+	bool pass = true;
+	int n = (int)result.period_ns.size();
+	
+	if (scenario == "pacing" && n > 0) {
+		
+		double target_ms = 1000.0 / BENCH_PACING_FPS;
+		double period_ms = bench_percentile_ms(result.period_ns, 0.50);
+		double cpu_ms = 1000.0 * (double)result.cpu / CLOCKS_PER_SEC / n;
+		
+		if (SDL_fabs(period_ms - target_ms) > target_ms * BENCH_PACING_TOLERANCE) {
+			fprintf(stderr, "pacing: median frame period %.3f ms, expected %.3f ms +- %.0f%%\n",
+			        period_ms, target_ms, BENCH_PACING_TOLERANCE * 100.0);
+			pass = false;
+		}
+		
+		if (cpu_ms > target_ms * BENCH_PACING_CPU_SHARE) {
+			fprintf(stderr, "pacing: %.3f ms cpu per frame, limit %.3f ms\n", cpu_ms, target_ms * BENCH_PACING_CPU_SHARE);
+			pass = false;
+		}
+	}
+	
+	if (scenario == "sfx_burst" && n > 0) {
+		
+		// n frames of count plays each (see update_ext()), every play stealing once the pool is full
+		uint64_t expected = (uint64_t)count * n;
+		uint64_t voices = (uint64_t)sfx_voices.voice_count();
+		
+		if (result.sfx_plays != expected) {
+			fprintf(stderr, "sfx_burst: %llu plays, expected %llu\n", (unsigned long long)result.sfx_plays, (unsigned long long)expected);
+			pass = false;
+		}
+		
+		if (expected > voices && result.sfx_steals < expected - voices) {
+			fprintf(stderr, "sfx_burst: %llu steals, expected at least %llu\n",
+			        (unsigned long long)result.sfx_steals, (unsigned long long)(expected - voices));
+			pass = false;
+		}
+		
+		if (result.sfx_max_active > (int)voices) {
+			fprintf(stderr, "sfx_burst: %d voices active, pool has %d\n", result.sfx_max_active, (int)voices);
+			pass = false;
+		}
+		
+		if (result.sfx_dropped || result.sfx_failed) {
+			fprintf(stderr, "sfx_burst: %llu dropped, %llu failed plays\n",
+			        (unsigned long long)result.sfx_dropped, (unsigned long long)result.sfx_failed);
+			pass = false;
+		}
+	}
+	
+	return pass;
+	
+}
+
+
+static int default_count(const char *scenario) {
+	
+	if (strcmp(scenario, "sprites") == 0 || strcmp(scenario, "texture_swaps") == 0) return 10000;
+	if (strcmp(scenario, "pipelined") == 0) return 10000;
+	if (strcmp(scenario, "text") == 0) return 100;
+	if (strcmp(scenario, "sfx_burst") == 0) return 64;
+	if (strcmp(scenario, "startup") == 0) return 20;
+	
+	return 0;
+}
+
+
+// the constructor before lazy startup - everything up front, including an audio device
+static Uint64 eager_startup() {
+	
+	Uint64 start = SDL_GetTicksNS();
+	
+	bool ok = SDL_Init(SDL_INIT_VIDEO | SDL_INIT_AUDIO) && TTF_Init() && MIX_Init();
+	
+	SDL_Window *window = ok ? SDL_CreateWindow("Application", 800, 500, 0) : NULL;
+	SDL_Renderer *renderer = window ? SDL_CreateRenderer(window, NULL) : NULL;
+	
+	SDL_AudioSpec audiospec;
+	audiospec.format = MIX_DEFAULT_FORMAT;
+	audiospec.channels = MIX_DEFAULT_CHANNELS;
+	audiospec.freq = MIX_DEFAULT_FREQUENCY;
+	
+	MIX_Mixer *mixer = renderer ? MIX_CreateMixerDevice(SDL_AUDIO_DEVICE_DEFAULT_PLAYBACK, &audiospec) : NULL;
+	MIX_Track *sfx_track = mixer ? MIX_CreateTrack(mixer) : NULL;
+	MIX_Track *music_track = mixer ? MIX_CreateTrack(mixer) : NULL;
+	
+	Uint64 end = SDL_GetTicksNS();
+	
+	if (!music_track) {
+		fprintf(stderr, "Warning - eager startup incomplete: %s\n", SDL_GetError());
+	}
+	
+	if (sfx_track) MIX_DestroyTrack(sfx_track);
+	if (music_track) MIX_DestroyTrack(music_track);
+	if (mixer) MIX_DestroyMixer(mixer);
+	if (renderer) SDL_DestroyRenderer(renderer);
+	if (window) SDL_DestroyWindow(window);
+	
+	MIX_Quit();
+	TTF_Quit();
+	SDL_Quit();
+	
+	return end - start;
+}
+
+
+// each round starts from nothing - the last release takes SDL down, so every construction re-initializes
+static void bench_startup(int rounds) {
+	
+	std::vector<Uint64> construct_ns, audio_ns, text_ns, lazy_sum_ns, eager_ns;
+	int audio_devices = 0;
+	
+	for (int r = 0; r < rounds; r++) {
+		
+		bench_headless(); // previous round's SDL_Quit() dropped the hints
+		
+		Uint64 start = SDL_GetTicksNS();
+		BenchApp app("startup", 0, 0);
+		Uint64 constructed = SDL_GetTicksNS();
+		
+		// first sound and first font - what the constructor used to do up front
+		bool audio = app.open_audio_now();
+		Uint64 audio_open = SDL_GetTicksNS();
+		
+		bool text = SDL_Runtime::instance().acquire_text();
+		Uint64 text_open = SDL_GetTicksNS();
+		
+		construct_ns.push_back(constructed - start);
+		audio_ns.push_back(audio_open - constructed);
+		text_ns.push_back(text_open - audio_open);
+		lazy_sum_ns.push_back(text_open - start);
+		
+		if (audio) {
+			audio_devices++;
+		}
+		if (text) {
+			SDL_Runtime::instance().release_text();
+		}
+	} // app goes here - last release shuts SDL down before the next round
+	
+	for (int r = 0; r < rounds; r++) {
+		bench_headless();
+		eager_ns.push_back(eager_startup());
+	}
+	
+	printf("{\"scenario\":\"startup\",\"rounds\":%d,"
+	       "\"construct_p50_ms\":%.3f,\"first_audio_p50_ms\":%.3f,\"first_text_p50_ms\":%.3f,"
+	       "\"lazy_sum_p50_ms\":%.3f,\"eager_p50_ms\":%.3f,\"audio_devices_per_round\":%.2f}\n",
+	       rounds,
+	       bench_percentile_ms(construct_ns, 0.50),
+	       bench_percentile_ms(audio_ns, 0.50),
+	       bench_percentile_ms(text_ns, 0.50),
+	       bench_percentile_ms(lazy_sum_ns, 0.50),
+	       bench_percentile_ms(eager_ns, 0.50),
+	       rounds ? (double)audio_devices / rounds : 0.0);
+	fflush(stdout);
+	
+}
+
+
+int main(int argc, char *argv[]) {
+	
+	const char *all[] = {"sprites", "texture_swaps", "text", "sfx_burst", "pacing", "on_demand", "pipelined", "startup"};
+	
+	const char *which = argc > 1 ? argv[1] : "all";
+	int frames = argc > 2 ? atoi(argv[2]) : BENCH_DEFAULT_FRAMES;
+	int count = argc > 3 ? atoi(argv[3]) : -1;
+	
+	int failures = 0;
+	
+	for (const char *scenario : all) {
+		
+		if (strcmp(which, "all") != 0 && strcmp(which, scenario) != 0) {
+			continue;
+		}
+		
+		try {
+			if (strcmp(scenario, "startup") == 0) {
+				bench_startup(count >= 0 ? count : default_count(scenario));
+				continue;
+			}
+			
+			bench_headless(); // previous scenario's SDL_Quit() dropped the hints
+			
+			BenchApp app(scenario, frames, count >= 0 ? count : default_count(scenario));
+			app.run();
+			app.report();
+			if (!app.check()) {
+				failures++;
+			}
+		}
+		catch (const std::exception &e) {
+			fprintf(stderr, "%s: %s", scenario, e.what());
+			failures++;
+		}
+	}
+	
+	return failures ? 1 : 0;
+}
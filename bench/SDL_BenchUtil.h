@@ -0,0 +1,74 @@
+#ifndef SDL_BENCHUTIL_H
+#define SDL_BENCHUTIL_H
+
+// Helpers shared by the headless benchmarks
+
+#include <SDL3/SDL.h>
+
+#include <algorithm>
+#include <vector>
+
+#include <string.h>
+
+#ifndef MIX_DEFAULT_FREQUENCY
+#define MIX_DEFAULT_FREQUENCY 44100
+#endif
+#ifndef MIX_DEFAULT_CHANNELS
+#define MIX_DEFAULT_CHANNELS 2
+#endif
+
+
+// route video, rendering and audio to drivers that need no gpu, display or sound card -
+// SDL_Quit() resets hints, so the same routing also goes into the environment, which SDL
+// reads as a fallback on every init
+static inline void bench_headless() {
+	SDL_setenv_unsafe("SDL_VIDEO_DRIVER", "offscreen,dummy", 1);
+	SDL_setenv_unsafe("SDL_RENDER_DRIVER", "software", 1);
+	SDL_setenv_unsafe("SDL_AUDIO_DRIVER", "dummy", 1);
+	
+	SDL_SetHint(SDL_HINT_VIDEO_DRIVER, "offscreen,dummy");
+	SDL_SetHint(SDL_HINT_RENDER_DRIVER, "software");
+	SDL_SetHint(SDL_HINT_AUDIO_DRIVER, "dummy");
+}
+
+
+// short silent 16 bit pcm wav, built in memory so no asset files are needed
+static inline std::vector<Uint8> bench_make_wav(int milliseconds = 50) {
+	
+	const int frames = MIX_DEFAULT_FREQUENCY * milliseconds / 1000;
+	const int data_bytes = frames * MIX_DEFAULT_CHANNELS * 2;
+	
+	std::vector<Uint8> wav(44 + data_bytes, 0);
+	Uint8 *p = wav.data();
+	
+	auto u32 = [](Uint8 *at, Uint32 v) { for (int i = 0; i < 4; i++) at[i] = (Uint8)(v >> (8 * i)); };
+	auto u16 = [](Uint8 *at, Uint16 v) { at[0] = (Uint8)v; at[1] = (Uint8)(v >> 8); };
+	
+	memcpy(p, "RIFF", 4);      u32(p + 4, 36 + data_bytes);
+	memcpy(p + 8, "WAVEfmt ", 8); u32(p + 16, 16);
+	u16(p + 20, 1);                                   // pcm
+	u16(p + 22, MIX_DEFAULT_CHANNELS);
+	u32(p + 24, MIX_DEFAULT_FREQUENCY);
+	u32(p + 28, MIX_DEFAULT_FREQUENCY * MIX_DEFAULT_CHANNELS * 2);
+	u16(p + 32, MIX_DEFAULT_CHANNELS * 2);
+	u16(p + 34, 16);
+	memcpy(p + 36, "data", 4); u32(p + 40, data_bytes);
+	
+	return wav;
+}
+
+
+// value at fraction p of an unsorted sample set, in milliseconds
+static inline double bench_percentile_ms(std::vector<Uint64> samples, double p) {
+	
+	if (samples.empty()) {
+		return 0.0;
+	}
+	
+	std::sort(samples.begin(), samples.end());
+	size_t i = (size_t)(p * (samples.size() - 1) + 0.5);
+	
+	return (double)samples[i] / (double)SDL_NS_PER_MS;
+}
+
+#endif
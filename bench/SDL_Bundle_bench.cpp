@@ -0,0 +1,241 @@
+// Startup benchmark: loading a set of images and sound effects from loose
+// PNG/WAV files against the same set from a memory-mapped SDL_Bundle. Both
+// paths upload into an SDL_AssetCache on a software renderer and predecode
+// the audio, so the difference is file access plus image decoding. Files are
+// generated in the temp directory and sit in the OS file cache for both runs.
+//
+//   SDL_Bundle_bench [images] [rounds]
+
+#include "../SDL_AssetCache.h"
+#include "../SDL_Bundle.h"
+#include "SDL_BenchUtil.h"
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define BENCH_DEFAULT_IMAGES 200
+#define BENCH_DEFAULT_ROUNDS 10
+#define BENCH_AUDIO_FILES 8
+#define BENCH_LARGE_EVERY 50 // every nth image is too large for an atlas page
+
+namespace fs = std::filesystem;
+
+
+// smooth gradient with noise - compresses like typical sprite art, not like a flat fill
+static SDL_Surface *make_image(int size, int seed) {
+	
+	SDL_Surface *surface = SDL_CreateSurface(size, size, SDL_PIXELFORMAT_RGBA32);
+	if (!surface) {
+		return NULL;
+	}
+	
+	for (int y = 0; y < size; y++) {
+		Uint8 *row = (Uint8*)surface->pixels + (size_t)y * surface->pitch;
+		for (int x = 0; x < size; x++) {
+			row[x * 4 + 0] = (Uint8)(x * 255 / size + seed);
+			row[x * 4 + 1] = (Uint8)(y * 255 / size);
+			row[x * 4 + 2] = (Uint8)(SDL_rand(32) + seed * 7);
+			row[x * 4 + 3] = (x + y) % 17 ? 255 : 0;
+		}
+	}
+	
+	return surface;
+}
+
+
+static double load_loose(SDL_Renderer *renderer, const std::vector<std::string> &images, const std::vector<std::string> &sounds) {
+	
+	Uint64 start = SDL_GetTicksNS();
+	
+	SDL_AssetCache cache;
+	cache.set_renderer(renderer);
+	
+	for (const std::string &path : images) {
+		cache.load(path);
+	}
+	
+	std::vector<MIX_Audio*> audio;
+	for (const std::string &path : sounds) {
+		audio.push_back(MIX_LoadAudio(NULL, path.c_str(), true));
+	}
+	
+	Uint64 end = SDL_GetTicksNS();
+	
+	for (MIX_Audio *a : audio) {
+		MIX_DestroyAudio(a);
+	}
+	
+	return (double)(end - start) / (double)SDL_NS_PER_MS;
+}
+
+
+static double load_bundle(SDL_Renderer *renderer, const char *bundle_path, const std::vector<std::string> &images, const std::vector<std::string> &sounds) {
+	
+	Uint64 start = SDL_GetTicksNS();
+	
+	SDL_Bundle bundle;
+	bundle.open(bundle_path);
+	
+	SDL_AssetCache cache;
+	cache.set_renderer(renderer);
+	cache.set_bundle(&bundle);
+	
+	for (const std::string &path : images) {
+		cache.load(path);
+	}
+	
+	std::vector<MIX_Audio*> audio;
+	for (const std::string &path : sounds) {
+		audio.push_back(bundle.audio(NULL, path, true));
+	}
+	
+	Uint64 end = SDL_GetTicksNS();
+	
+	if (cache.bundle_loads() != (int)images.size()) {
+		fprintf(stderr, "Warning: only %d of %d images came from the bundle.\n", cache.bundle_loads(), (int)images.size());
+	}
+	
+	for (MIX_Audio *a : audio) {
+		MIX_DestroyAudio(a);
+	}
+	
+	return (double)(end - start) / (double)SDL_NS_PER_MS;
+}
+
+
+static Uint64 file_bytes(const std::vector<std::string> &paths) {
+	
+	Uint64 total = 0;
+	std::error_code error;
+	
+	for (const std::string &path : paths) {
+		total += fs::file_size(path, error);
+	}
+	
+	return total;
+}
+
+
+static void report(const char *mode, int images, int sounds, Uint64 bytes, std::vector<double> &ms) {
+	
+	std::sort(ms.begin(), ms.end());
+	
+	printf("{\"bench\":\"bundle_startup\",\"mode\":\"%s\",\"images\":%d,\"audio\":%d,\"bytes\":%llu,\"ms_min\":%.3f,\"ms_p50\":%.3f,\"ms_max\":%.3f}\n",
+		mode, images, sounds, (unsigned long long)bytes, ms.front(), ms[ms.size() / 2], ms.back());
+}
+
+
+int main(int argc, char *argv[]) {
+	
+	int image_count = argc > 1 ? atoi(argv[1]) : BENCH_DEFAULT_IMAGES;
+	int rounds = argc > 2 ? atoi(argv[2]) : BENCH_DEFAULT_ROUNDS;
+	if (image_count < 1 || rounds < 1) {
+		fprintf(stderr, "usage: %s [images] [rounds]\n", argv[0]);
+		return 1;
+	}
+	
+	bench_headless();
+	
+	if (!MIX_Init()) {
+		fprintf(stderr, "Error initiating MIX: %s\n", SDL_GetError());
+		return 1;
+	}
+	
+	// software renderer on a surface - no window or video driver needed
+	SDL_Surface *target = SDL_CreateSurface(256, 256, SDL_PIXELFORMAT_RGBA32);
+	SDL_Renderer *renderer = target ? SDL_CreateSoftwareRenderer(target) : NULL;
+	if (!renderer) {
+		fprintf(stderr, "Error creating renderer: %s\n", SDL_GetError());
+		return 1;
+	}
+	
+	// loose files
+	std::error_code error;
+	fs::path dir = fs::temp_directory_path(error) / "sdl_bundle_bench";
+	fs::remove_all(dir, error);
+	fs::create_directories(dir / "sfx", error);
+	
+	std::vector<std::string> images;
+	std::vector<std::string> sounds;
+	SDL_srand(1);
+	
+	for (int i = 0; i < image_count; i++) {
+		
+		int size = i % BENCH_LARGE_EVERY == 0 ? 512 : 32 + SDL_rand(7) * 32;
+		std::string path = (dir / ("sprite" + std::to_string(i) + ".png")).generic_string();
+		
+		SDL_Surface *surface = make_image(size, i);
+		if (!surface || !IMG_SavePNG(surface, path.c_str())) {
+			fprintf(stderr, "Error writing \"%s\": %s\n", path.c_str(), SDL_GetError());
+			return 1;
+		}
+		SDL_DestroySurface(surface);
+		
+		images.push_back(path);
+	}
+	
+	std::vector<Uint8> wav = bench_make_wav(500);
+	
+	for (int i = 0; i < BENCH_AUDIO_FILES; i++) {
+		
+		std::string path = (dir / "sfx" / ("hit" + std::to_string(i) + ".wav")).generic_string();
+		
+		if (!SDL_SaveFile(path.c_str(), wav.data(), wav.size())) {
+			fprintf(stderr, "Error writing \"%s\": %s\n", path.c_str(), SDL_GetError());
+			return 1;
+		}
+		
+		sounds.push_back(path);
+	}
+	
+	// same set, packed - entry names are the loose paths so lookups match
+	std::string bundle_path = (dir / "bench.bundle").generic_string();
+	SDL_BundleWriter writer;
+	
+	for (const std::string &path : images) {
+		writer.add_image_file(path, path.c_str());
+	}
+	for (const std::string &path : sounds) {
+		writer.add_audio_file(path, path.c_str());
+	}
+	
+	if (!writer.write(bundle_path.c_str())) {
+		return 1;
+	}
+	writer.clear();
+	
+	// alternate the order each round so neither side always runs second
+	std::vector<double> loose_ms;
+	std::vector<double> bundle_ms;
+	
+	for (int r = 0; r < rounds; r++) {
+		if (r % 2 == 0) {
+			loose_ms.push_back(load_loose(renderer, images, sounds));
+			bundle_ms.push_back(load_bundle(renderer, bundle_path.c_str(), images, sounds));
+		}
+		else {
+			bundle_ms.push_back(load_bundle(renderer, bundle_path.c_str(), images, sounds));
+			loose_ms.push_back(load_loose(renderer, images, sounds));
+		}
+	}
+	
+	std::vector<std::string> all = images;
+	all.insert(all.end(), sounds.begin(), sounds.end());
+	
+	report("loose", (int)images.size(), (int)sounds.size(), file_bytes(all), loose_ms);
+	report("bundle", (int)images.size(), (int)sounds.size(), file_bytes({bundle_path}), bundle_ms);
+	
+	SDL_DestroyRenderer(renderer);
+	SDL_DestroySurface(target);
+	
+	fs::remove_all(dir, error);
+	
+	MIX_Quit();
+	SDL_Quit();
+	
+	return 0;
+}
@@ -0,0 +1,111 @@
+// Microbenchmark: string-keyed std::map lookups (previous SDL_Soundboard play
+// path) against SDL_SoundID handle lookups. Runs on SDL's dummy audio driver.
+// The play comparison uses the same shared device mixer and an equal size
+// voice pool on both sides, so only the lookup differs.
+
+#include "../SDL_Soundboard.h"
+#include "SDL_BenchUtil.h"
+
+#include <string>
+#include <vector>
+
+#include <stdio.h>
+
+#define SOUND_COUNT 64
+#define ITERATIONS 1000000
+#define PLAY_ITERATIONS 100000
+
+
+// the lookup previously done by play_sfx(std::string id) - by-value string, find, then operator[]
+static MIX_Audio *legacy_lookup(std::map<std::string, MIX_Audio*> &audios, std::string id) {
+	
+	if (audios.find(id) == audios.end()) {
+		return NULL;
+	}
+	
+	return audios[id];
+}
+
+
+static double ns_per_op(Uint64 start, Uint64 end, int ops) {
+	return (double)(end - start) / (double)ops;
+}
+
+
+int main(int, char *[]) {
+	
+	SDL_SetHint(SDL_HINT_AUDIO_DRIVER, "dummy");
+	
+	SDL_Soundboard board;
+	SDL_Runtime::instance().audio(); // board holds the runtime - start decoders for the raw loads below
+	
+	std::vector<Uint8> wav = bench_make_wav();
+	std::map<std::string, MIX_Audio*> legacy;
+	std::vector<std::string> names;
+	std::vector<SDL_SoundID> handles;
+	
+	for (int i = 0; i < SOUND_COUNT; i++) {
+		
+		MIX_Audio *audio = MIX_LoadAudio_IO(NULL, SDL_IOFromConstMem(wav.data(), wav.size()), true, true);
+		if (!audio) {
+			fprintf(stderr, "Error creating bench audio: %s\n", SDL_GetError());
+			return 1;
+		}
+		
+		// realistic names - long enough to defeat small string optimization
+		char name[64];
+		SDL_snprintf(name, sizeof(name), "sfx/effects/impact_metal_%03d", i);
+		
+		names.push_back(name);
+		legacy[name] = audio;
+		handles.push_back(board.push_audio(name, audio)); // board owns and frees the audio
+	}
+	
+	// lookups only
+	MIX_Audio *volatile sink = NULL; // the pointer itself is volatile so every store happens
+	
+	Uint64 start = SDL_GetTicksNS();
+	for (int i = 0; i < ITERATIONS; i++) {
+		sink = legacy_lookup(legacy, names[i % SOUND_COUNT]);
+	}
+	Uint64 legacy_end = SDL_GetTicksNS();
+	for (int i = 0; i < ITERATIONS; i++) {
+		sink = board.audio(handles[i % SOUND_COUNT]);
+	}
+	Uint64 handle_end = SDL_GetTicksNS();
+	(void)sink;
+	
+	// full play path - string lookup into a voice pool of the board's size on the
+	// board's own device mixer, against the board's handle path
+	board.play_sfx(handles[0]); // opens the device and the board's voices outside the timing
+	
+	MIX_Mixer *mixer = SDL_Runtime::instance().mixer();
+	SDL_VoicePool legacy_voices;
+	if (!mixer || !legacy_voices.create(mixer)) {
+		fprintf(stderr, "Error creating bench voices: %s\n", SDL_GetError());
+		return 1;
+	}
+	
+	Uint64 play_start = SDL_GetTicksNS();
+	for (int i = 0; i < PLAY_ITERATIONS; i++) {
+		legacy_voices.play(legacy_lookup(legacy, names[i % SOUND_COUNT]));
+	}
+	Uint64 legacy_play_end = SDL_GetTicksNS();
+	for (int i = 0; i < PLAY_ITERATIONS; i++) {
+		board.play_sfx(handles[i % SOUND_COUNT]);
+	}
+	Uint64 handle_play_end = SDL_GetTicksNS();
+	
+	printf("{\"bench\":\"soundboard\",\"sounds\":%d,"
+	       "\"lookup_string_ns\":%.2f,\"lookup_handle_ns\":%.2f,"
+	       "\"play_string_ns\":%.2f,\"play_handle_ns\":%.2f}\n",
+	       SOUND_COUNT,
+	       ns_per_op(start, legacy_end, ITERATIONS),
+	       ns_per_op(legacy_end, handle_end, ITERATIONS),
+	       ns_per_op(play_start, legacy_play_end, PLAY_ITERATIONS),
+	       ns_per_op(legacy_play_end, handle_play_end, PLAY_ITERATIONS));
+	
+	legacy_voices.destroy();
+	
+	return 0;
+}
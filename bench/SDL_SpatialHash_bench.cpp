@@ -0,0 +1,283 @@
+// SDL_SpatialHash against brute force at 10k - 1M objects. World size grows
+// with object count so density (and hits per query) stays constant. Grid
+// results are checked against brute force outside the timed sections and the
+// run exits non-zero on any mismatch.
+//
+//   SDL_SpatialHash_bench [queries]
+
+#include "../SDL_SpatialHash.h"
+
+#include <algorithm>
+#include <vector>
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define BENCH_DEFAULT_QUERIES 1000
+#define BENCH_BRUTE_PAIRS_LIMIT 20000 // O(n^2) pair scan is skipped above this
+#define BENCH_VERIFY_QUERIES 20       // queries of each kind checked against brute force
+#define BENCH_KNN 8
+
+
+static bool overlaps(const SDL_FRect &a, const SDL_FRect &b) {
+	return a.x <= b.x + b.w && b.x <= a.x + a.w && a.y <= b.y + b.h && b.y <= a.y + a.h;
+}
+
+
+static float distance_sq(SDL_FPoint p, const SDL_FRect &r) {
+	float dx = std::max(std::max(r.x - p.x, 0.0f), p.x - (r.x + r.w));
+	float dy = std::max(std::max(r.y - p.y, 0.0f), p.y - (r.y + r.h));
+	return dx * dx + dy * dy;
+}
+
+
+static double us_per(Uint64 start, Uint64 end, int n) {
+	return n ? (double)(end - start) / 1000.0 / n : 0.0;
+}
+
+
+// grid and brute force report in different orders - compare as sorted sets
+template <typename T>
+static bool same_set(std::vector<T> a, std::vector<T> b) {
+	std::sort(a.begin(), a.end());
+	std::sort(b.begin(), b.end());
+	return a == b;
+}
+
+
+// brute force k nearest - distances only, ties may pick different ids than the grid
+static std::vector<float> nearest_distances(SDL_FPoint point, int k, const std::vector<SDL_FRect> &rects) {
+	
+	std::vector<float> all(rects.size());
+	for (size_t i = 0; i < rects.size(); i++) {
+		all[i] = distance_sq(point, rects[i]);
+	}
+	
+	k = std::min(k, (int)all.size());
+	std::partial_sort(all.begin(), all.begin() + k, all.end());
+	all.resize(k);
+	
+	return all;
+}
+
+
+static int verify_queries(SDL_SpatialHash &grid, const std::vector<SDL_FRect> &rects, const std::vector<SDL_FRect> &views, const std::vector<SDL_FPoint> &points) {
+	
+	int failures = 0;
+	int n = (int)rects.size();
+	int checks = std::min((int)views.size(), BENCH_VERIFY_QUERIES);
+	std::vector<int> found;
+	std::vector<int> expected;
+	
+	for (int q = 0; q < checks; q++) {
+		
+		grid.query_rect(views[q], found);
+		expected.clear();
+		for (int i = 0; i < n; i++) {
+			if (overlaps(rects[i], views[q])) expected.push_back(i);
+		}
+		if (!same_set(found, expected)) {
+			fprintf(stderr, "Error - %d objects: rect query %d returned %zu ids, brute force %zu.\n", n, q, found.size(), expected.size());
+			failures++;
+		}
+		
+		grid.query_radius(points[q], 64.0f, found);
+		expected.clear();
+		for (int i = 0; i < n; i++) {
+			if (distance_sq(points[q], rects[i]) <= 64.0f * 64.0f) expected.push_back(i);
+		}
+		if (!same_set(found, expected)) {
+			fprintf(stderr, "Error - %d objects: radius query %d returned %zu ids, brute force %zu.\n", n, q, found.size(), expected.size());
+			failures++;
+		}
+		
+		grid.nearest(points[q], BENCH_KNN, found);
+		std::vector<float> distances;
+		for (int id : found) {
+			distances.push_back(distance_sq(points[q], rects[id]));
+		}
+		if (!same_set(distances, nearest_distances(points[q], BENCH_KNN, rects))) {
+			fprintf(stderr, "Error - %d objects: nearest query %d does not match brute force.\n", n, q);
+			failures++;
+		}
+	}
+	
+	// far outside the populated area - ring search must clip to it, not walk every ring in between
+	SDL_FPoint far_points[] = {{-1.0e6f, -1.0e6f}, {2.0e6f, 500.0f}};
+	for (SDL_FPoint far : far_points) {
+		
+		Uint64 start = SDL_GetTicksNS();
+		grid.nearest(far, BENCH_KNN, found);
+		Uint64 elapsed = SDL_GetTicksNS() - start;
+		
+		std::vector<float> distances;
+		for (int id : found) {
+			distances.push_back(distance_sq(far, rects[id]));
+		}
+		if (!same_set(distances, nearest_distances(far, BENCH_KNN, rects))) {
+			fprintf(stderr, "Error - %d objects: nearest query at (%g, %g) does not match brute force.\n", n, far.x, far.y);
+			failures++;
+		}
+		if (elapsed > SDL_NS_PER_SECOND) {
+			fprintf(stderr, "Error - %d objects: nearest query at (%g, %g) took %.3f s.\n", n, far.x, far.y, (double)elapsed / SDL_NS_PER_SECOND);
+			failures++;
+		}
+	}
+	
+	return failures;
+}
+
+
+static int run(int n, int queries) {
+	
+	float world = sqrtf((float)n) * 48.0f;
+	
+	SDL_srand(7);
+	std::vector<SDL_FRect> rects(n);
+	for (SDL_FRect &r : rects) {
+		r = {SDL_randf() * world, SDL_randf() * world, 4.0f + SDL_randf() * 12.0f, 4.0f + SDL_randf() * 12.0f};
+	}
+	
+	std::vector<SDL_FRect> views(queries);
+	std::vector<SDL_FPoint> points(queries);
+	for (int i = 0; i < queries; i++) {
+		views[i] = {SDL_randf() * world, SDL_randf() * world, 800.0f, 500.0f};
+		points[i] = {SDL_randf() * world, SDL_randf() * world};
+	}
+	
+	// brute force gets fewer queries at large n, times are per query anyway
+	int brute_queries = std::max(1, std::min(queries, 100000000 / n / 10));
+	
+	SDL_SpatialHash grid(32.0f);
+	std::vector<int> out;
+	std::vector<std::pair<float, int>> all(n); // brute force knn scratch - allocated outside every timed section
+	size_t sink = 0;
+	
+	Uint64 t0 = SDL_GetTicksNS();
+	for (int i = 0; i < n; i++) {
+		grid.insert(i, rects[i]);
+	}
+	Uint64 t1 = SDL_GetTicksNS();
+	
+	// view culling
+	for (int q = 0; q < queries; q++) {
+		grid.query_rect(views[q], out);
+		sink += out.size();
+	}
+	Uint64 t2 = SDL_GetTicksNS();
+	for (int q = 0; q < brute_queries; q++) {
+		out.clear();
+		for (int i = 0; i < n; i++) {
+			if (overlaps(rects[i], views[q])) out.push_back(i);
+		}
+		sink += out.size();
+	}
+	Uint64 t3 = SDL_GetTicksNS();
+	
+	// radius
+	for (int q = 0; q < queries; q++) {
+		grid.query_radius(points[q], 64.0f, out);
+		sink += out.size();
+	}
+	Uint64 t4 = SDL_GetTicksNS();
+	for (int q = 0; q < brute_queries; q++) {
+		out.clear();
+		for (int i = 0; i < n; i++) {
+			if (distance_sq(points[q], rects[i]) <= 64.0f * 64.0f) out.push_back(i);
+		}
+		sink += out.size();
+	}
+	Uint64 t5 = SDL_GetTicksNS();
+	
+	// k nearest
+	for (int q = 0; q < queries; q++) {
+		grid.nearest(points[q], BENCH_KNN, out);
+		sink += out.size();
+	}
+	Uint64 t6 = SDL_GetTicksNS();
+	for (int q = 0; q < brute_queries; q++) {
+		for (int i = 0; i < n; i++) {
+			all[i] = {distance_sq(points[q], rects[i]), i};
+		}
+		std::partial_sort(all.begin(), all.begin() + BENCH_KNN, all.end());
+		sink += all[0].second;
+	}
+	Uint64 t7 = SDL_GetTicksNS();
+	
+	int failures = verify_queries(grid, rects, views, points);
+	
+	// incremental update - everything moves a little
+	for (int i = 0; i < n; i++) {
+		rects[i].x += SDL_randf() * 4.0f - 2.0f;
+		rects[i].y += SDL_randf() * 4.0f - 2.0f;
+	}
+	Uint64 t8 = SDL_GetTicksNS();
+	for (int i = 0; i < n; i++) {
+		grid.update(i, rects[i]);
+	}
+	Uint64 t9 = SDL_GetTicksNS();
+	
+	// collision broad phase
+	std::vector<std::pair<int, int>> pairs;
+	grid.query_pairs(pairs);
+	Uint64 t10 = SDL_GetTicksNS();
+	
+	double brute_pairs_ms = -1.0;
+	if (n <= BENCH_BRUTE_PAIRS_LIMIT) {
+		std::vector<std::pair<int, int>> expected;
+		expected.reserve(pairs.size());
+		Uint64 t11 = SDL_GetTicksNS();
+		for (int i = 0; i < n; i++) {
+			for (int j = i + 1; j < n; j++) {
+				if (overlaps(rects[i], rects[j])) expected.push_back({i, j});
+			}
+		}
+		brute_pairs_ms = (double)(SDL_GetTicksNS() - t11) / (double)SDL_NS_PER_MS;
+		sink += expected.size();
+		
+		std::vector<std::pair<int, int>> found = pairs;
+		for (std::pair<int, int> &pair : found) {
+			if (pair.first > pair.second) std::swap(pair.first, pair.second);
+		}
+		if (!same_set(found, expected)) {
+			fprintf(stderr, "Error - %d objects: grid found %zu pairs, brute force %zu.\n", n, found.size(), expected.size());
+			failures++;
+		}
+	}
+	
+	printf("{\"bench\":\"spatial_hash\",\"objects\":%d,\"build_ms\":%.3f,"
+	       "\"view_grid_us\":%.3f,\"view_brute_us\":%.3f,"
+	       "\"radius_grid_us\":%.3f,\"radius_brute_us\":%.3f,"
+	       "\"knn8_grid_us\":%.3f,\"knn8_brute_us\":%.3f,"
+	       "\"update_all_ms\":%.3f,\"pairs\":%zu,\"pairs_grid_ms\":%.3f,\"pairs_brute_ms\":%.3f,\"sink\":%zu}\n",
+	       n, (double)(t1 - t0) / SDL_NS_PER_MS,
+	       us_per(t1, t2, queries), us_per(t2, t3, brute_queries),
+	       us_per(t3, t4, queries), us_per(t4, t5, brute_queries),
+	       us_per(t5, t6, queries), us_per(t6, t7, brute_queries),
+	       (double)(t9 - t8) / SDL_NS_PER_MS, pairs.size(), (double)(t10 - t9) / SDL_NS_PER_MS, brute_pairs_ms,
+	       sink);
+	fflush(stdout);
+	
+	return failures;
+	
+}
+
+
+int main(int argc, char *argv[]) {
+	
+	int queries = argc > 1 ? atoi(argv[1]) : BENCH_DEFAULT_QUERIES;
+	
+	const int counts[] = {10000, 100000, 1000000};
+	int failures = 0;
+	for (int n : counts) {
+		failures += run(n, queries);
+	}
+	
+	if (failures) {
+		fprintf(stderr, "%d grid results differ from brute force.\n", failures);
+		return 1;
+	}
+	
+	return 0;
+}
@@ -0,0 +1,89 @@
+// Scaling benchmark for SDL_World: entity count x thread count, three systems
+// (two conflicting, one independent) stepped for a fixed number of updates.
+//
+//   SDL_World_bench [updates]
+
+#include "../SDL_World.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define BENCH_DEFAULT_UPDATES 60
+
+
+struct Position { float x, y; };
+struct Velocity { float x, y; };
+struct Lifetime { float age; };
+
+
+static double run(int entities, int threads, int updates) {
+	
+	SDL_World world;
+	world.job_pool().set_threads(threads - 1); // calling thread works too - 1 thread = no workers, runs inline
+	
+	SDL_srand(1);
+	for (int i = 0; i < entities; i++) {
+		SDL_Entity e = world.create();
+		world.add<Position>(e, {SDL_randf() * 800.0f, SDL_randf() * 500.0f});
+		world.add<Velocity>(e, {(SDL_randf() - 0.5f) * 200.0f, (SDL_randf() - 0.5f) * 200.0f});
+		world.add<Lifetime>(e, {0.0f});
+	}
+	
+	world.add_system("move", SDL_World::mask<Velocity>(), SDL_World::mask<Position>(), [](SDL_World &w, double delta) {
+		float dt = (float)delta;
+		w.parallel_each<Position, Velocity>([dt](SDL_Entity, Position &p, Velocity &v) {
+			p.x += v.x * dt;
+			p.y += v.y * dt;
+		});
+	});
+	
+	world.add_system("age", 0, SDL_World::mask<Lifetime>(), [](SDL_World &w, double delta) {
+		float dt = (float)delta;
+		w.parallel_each<Lifetime>([dt](SDL_Entity, Lifetime &l) {
+			l.age += dt;
+		});
+	});
+	
+	world.add_system("bounce", SDL_World::mask<Position>(), SDL_World::mask<Velocity>(), [](SDL_World &w, double) {
+		w.parallel_each<Velocity, Position>([](SDL_Entity, Velocity &v, Position &p) {
+			if (p.x < 0.0f || p.x > 800.0f) v.x = -v.x;
+			if (p.y < 0.0f || p.y > 500.0f) v.y = -v.y;
+		});
+	});
+	
+	world.update(1.0 / 60.0); // warm up - starts workers, builds phases
+	
+	Uint64 start = SDL_GetTicksNS();
+	for (int i = 0; i < updates; i++) {
+		world.update(1.0 / 60.0);
+	}
+	Uint64 end = SDL_GetTicksNS();
+	
+	return (double)(end - start) / (double)SDL_NS_PER_MS / updates;
+}
+
+
+int main(int argc, char *argv[]) {
+	
+	int updates = argc > 1 ? atoi(argv[1]) : BENCH_DEFAULT_UPDATES;
+	int cores = SDL_GetNumLogicalCPUCores();
+	
+	const int entity_counts[] = {10000, 100000, 1000000};
+	
+	for (int entities : entity_counts) {
+		
+		double single = 0.0;
+		
+		for (int threads = 1; threads <= cores; threads *= 2) {
+			double ms = run(entities, threads, updates);
+			if (threads == 1) {
+				single = ms;
+			}
+			printf("{\"bench\":\"world\",\"entities\":%d,\"threads\":%d,\"update_ms\":%.3f,\"speedup\":%.2f}\n",
+			       entities, threads, ms, ms > 0.0 ? single / ms : 0.0);
+			fflush(stdout);
+		}
+	}
+	
+	return 0;
+}
@@ -1 +1 @@
-g++ main.cpp -o main.o -lSDL3 -lSDL3_image -lSDL3_ttf -lSDL3_mixer
+g++ main.cpp SDL_AtlasPacker.cpp SDL_AssetCache.cpp SDL_AssetLoader.cpp SDL_Bundle.cpp SDL_JobPool.cpp SDL_Profiler.cpp SDL_Runtime.cpp SDL_SpatialHash.cpp SDL_SpriteBatch.cpp SDL_TextCache.cpp SDL_VoicePool.cpp SDL_World.cpp -o main.o -pthread -lSDL3 -lSDL3_image -lSDL3_ttf -lSDL3_mixer
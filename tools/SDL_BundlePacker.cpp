@@ -0,0 +1,94 @@
+// Offline packer: decodes images to RGBA32 and collects audio files into one
+// bundle for SDL_Bundle. Entries are named by the path as given on the command
+// line (directories are walked recursively), so "assets/icon.png" in the
+// bundle answers SDL_AssetCache::load("assets/icon.png").
+//
+//   SDL_BundlePacker <output.bundle> <file|directory>...
+
+#include "../SDL_Bundle.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include <stdio.h>
+
+namespace fs = std::filesystem;
+
+
+static const char *image_extensions[] = {".png", ".jpg", ".jpeg", ".bmp", ".tga", ".gif", ".webp", ".qoi"};
+static const char *audio_extensions[] = {".wav", ".ogg", ".mp3", ".flac", ".opus", ".mod", ".xm", ".it", ".s3m"};
+
+
+template <size_t N>
+static bool has_extension(const std::string &ext, const char *(&list)[N]) {
+	for (const char *known : list) {
+		if (SDL_strcasecmp(ext.c_str(), known) == 0) {
+			return true;
+		}
+	}
+	return false;
+}
+
+
+int main(int argc, char *argv[]) {
+	
+	if (argc < 3) {
+		fprintf(stderr, "usage: %s <output.bundle> <file|directory>...\n", argv[0]);
+		return 1;
+	}
+	
+	// expand directories, sorted so the same tree always packs to the same file
+	std::vector<std::string> paths;
+	
+	for (int i = 2; i < argc; i++) {
+		
+		std::error_code error;
+		
+		if (fs::is_directory(argv[i], error)) {
+			for (const fs::directory_entry &entry : fs::recursive_directory_iterator(argv[i], error)) {
+				if (entry.is_regular_file()) {
+					paths.push_back(entry.path().generic_string());
+				}
+			}
+		}
+		else {
+			paths.push_back(fs::path(argv[i]).generic_string());
+		}
+	}
+	
+	std::sort(paths.begin(), paths.end());
+	
+	SDL_BundleWriter writer;
+	int images = 0;
+	int audios = 0;
+	int failed = 0;
+	
+	for (const std::string &path : paths) {
+		
+		std::string ext = fs::path(path).extension().string();
+		
+		if (has_extension(ext, image_extensions)) {
+			writer.add_image_file(path, path.c_str()) ? images++ : failed++;
+		}
+		else if (has_extension(ext, audio_extensions)) {
+			writer.add_audio_file(path, path.c_str()) ? audios++ : failed++;
+		}
+		else {
+			printf("skipping %s\n", path.c_str());
+		}
+	}
+	
+	if (!writer.write(argv[1])) {
+		return 1;
+	}
+	
+	printf("%s: %d images, %d audio files", argv[1], images, audios);
+	if (failed) {
+		printf(", %d failed", failed);
+	}
+	printf("\n");
+	
+	return failed ? 1 : 0;
+}